@@ -18,6 +18,10 @@
 
 #include "Pila.h" // Usado internamente por los iteradores
 
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+
 #include <cstdlib> // Para usar la funcin valor absoluto
 
 /**
@@ -53,21 +57,39 @@
  */
 template <class Clave, class Valor>
 class Arbus {
+public:
+	/**
+	 Pareja (clave, valor) guardada en el arbol. Es lo que
+	 devuelve *it al recorrerlo con un Iterador: una referencia
+	 a la pareja dentro de su nodo, que sigue siendo valida
+	 aunque el iterador avance.
+	 */
+	class Par {
+	public:
+		Par() {}
+		Par(const Clave &clave, const Valor &valor)
+			: _clave(clave), _valor(valor) {}
+
+		const Clave &clave() const { return _clave; }
+		const Valor &valor() const { return _valor; }
+
+		Clave _clave;
+		Valor _valor;
+	};
+
 private:
 	/**
 	 Clase nodo que almacena internamente la pareja (clave, valor)
 	 y los punteros al hijo izquierdo y al hijo derecho.
 	 */
-	class Nodo {
+	class Nodo : public Par {
 	public:
 		Nodo() : _iz(NULL), _dr(NULL) {}
 		Nodo(const Clave &clave, const Valor &valor) 
-			: _clave(clave), _valor(valor), _iz(NULL), _dr(NULL) {}
+			: Par(clave, valor), _iz(NULL), _dr(NULL) {}
 		Nodo(Nodo *iz, const Clave &clave, const Valor &valor, Nodo *dr)
-			: _clave(clave), _valor(valor), _iz(iz), _dr(dr) {}
+			: Par(clave, valor), _iz(iz), _dr(dr) {}
 
-		Clave _clave;
-		Valor _valor;
 		Nodo *_iz;
 		Nodo *_dr;
 	};
@@ -211,11 +233,31 @@ public:
 	 Clase interna que implementa un iterador sobre
 	 la lista que permite recorrer la lista e incluso
 	 alterar el valor de sus elementos.
+
+	 Tambin es un iterador de avance de la STL (con begin
+	 y end, por ejemplo en un for de rango) que recorre las
+	 claves en orden; *it es la pareja (Par) del nodo actual,
+	 con clave() y valor(). operator++ slo comprueba con assert que no
+	 estemos en el final.
 	 */
 	class Iterador {
 	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef Par value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const Par *pointer;
+		typedef const Par &reference;
+
+		/** Iterador fuera del rbol (como final()). */
+		Iterador() : _act(NULL) {}
+
 		void avanza() {
 			if (_act == NULL) throw EAccesoInvalido();
+			operator++();
+		}
+
+		Iterador &operator++() {
+			assert(_act != NULL);
 
 			// Si hay hijo derecho, saltamos al primero
 			// en inorden del hijo derecho
@@ -233,6 +275,23 @@ public:
 					_ascendientes.desapila();
 				}
 			}
+			return *this;
+		}
+
+		Iterador operator++(int) {
+			Iterador ret(*this);
+			operator++();
+			return ret;
+		}
+
+		const Par &operator*() const {
+			assert(_act != NULL);
+			return *_act;
+		}
+
+		const Par *operator->() const {
+			assert(_act != NULL);
+			return _act;
 		}
 
 		const Clave &clave() const {
@@ -257,7 +316,6 @@ public:
 		// tipo iterador
 		friend class Arbus;
 
-		Iterador() : _act(NULL) {}
 		Iterador(Nodo *act) {
 			_act = primeroInOrden(act);
 		}
@@ -306,6 +364,16 @@ public:
 		return Iterador(NULL);
 	}
 
+	/** Equivalentes a principio() y final() con los nombres
+	    de la STL, para los bucles for de rango. */
+	Iterador begin() const {
+		return Iterador(_ra);
+	}
+
+	Iterador end() const {
+		return final();
+	}
+
 
 	// //
 	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
@@ -0,0 +1,293 @@
+/*
+ * BFSParalela.h
+ *
+ * Bsqueda en anchura paralela con cambio de direccin, para
+ * BreadthFirstPaths y BreadthFirstDirectedPaths.
+ */
+
+#ifndef BFSPARALELA_H_
+#define BFSPARALELA_H_
+
+#include <atomic>
+#include <cstddef>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+typedef unsigned int uint;
+
+/**
+ * Bsqueda en anchura por niveles, repartiendo cada nivel entre varios
+ * hilos y eligiendo en cada uno la direccin ms barata (Beamer, Asanovic
+ * y Patterson, "Direction-Optimizing Breadth-First Search", 2012):
+ *
+ *   - Descendente: cada vrtice de la frontera recorre sus adyacentes
+ *     y reclama los que no se han visitado. La frontera es un vector de
+ *     vrtices, y un vrtice se reclama marcndolo en el bitmap de
+ *     visitados con una operacin atmica, as que cada uno lo encuentra
+ *     un solo hilo.
+ *   - Ascendente: cada vrtice sin visitar recorre sus predecesores
+ *     (los adyacentes del grafo inverso) y para en el primero que est
+ *     en la frontera, que ahora es un bitmap. Cada hilo se ocupa de un
+ *     tramo de palabras de los bitmaps, as que no hacen falta atmicas.
+ *
+ * Se empieza en descendente y se pasa a ascendente cuando las aristas
+ * que salen de la frontera superan 1/ALFA de las que quedan por mirar;
+ * se vuelve a descendente cuando la frontera, tras empezar a decrecer,
+ * baja de V/BETA vrtices. En los grafos con grado muy desigual (redes
+ * sociales) los niveles centrales, que contienen casi todo el grafo, se
+ * hacen en ascendente y miran una pequea parte de las aristas.
+ *
+ * Al terminar, distTo es igual que con la bsqueda secuencial. edgeTo
+ * tambin da caminos mnimos, pero si hay varios no tiene por qu elegir
+ * el mismo predecesor (depende de qu hilo llegue antes).
+ *
+ * TipoGrafo y TipoInverso son grafos cuyo adj(v) se recorre con begin/end
+ * y tiene numElems (Grafo, GrafoDirigido, GrafoCSR). Para un grafo no
+ * dirigido el inverso es el propio grafo.
+ */
+template <class TipoGrafo, class TipoInverso>
+class BFSParalela {
+public:
+
+	/** Divisor del umbral para pasar a ascendente. */
+	static const uint ALFA = 15;
+
+	/** Divisor del umbral para volver a descendente. */
+	static const uint BETA = 18;
+
+	/** Vrtices que merece la pena darle como mnimo a cada hilo. */
+	static const std::size_t MIN_POR_HILO = 1 << 14;
+
+	/**
+	 * @param G grafo que se recorre.
+	 * @param inv su inverso (el mismo G si no es dirigido).
+	 * @param numHilos nmero de hilos (0 para usar uno por ncleo).
+	 */
+	BFSParalela(const TipoGrafo &G, const TipoInverso &inv, uint numHilos) :
+			_G(G), _inv(inv), _V(G.V()), _palabras((G.V() + 63) / 64),
+			_numHilos(numHilos), _locales(NULL) {
+		if (_numHilos == 0)
+			_numHilos = std::thread::hardware_concurrency();
+		if (_numHilos == 0)
+			_numHilos = 1;
+		_visitados = new std::atomic<uint64_t>[_palabras];
+		_frontera = new uint64_t[_palabras];
+		_siguiente = new uint64_t[_palabras];
+		for (std::size_t i = 0; i < _palabras; ++i)
+			_visitados[i].store(0, std::memory_order_relaxed);
+		_locales = new std::vector<uint>[_numHilos];
+	}
+
+	~BFSParalela() {
+		delete[] _visitados;
+		delete[] _frontera;
+		delete[] _siguiente;
+		delete[] _locales;
+	}
+
+	/**
+	 * Recorre el grafo desde las fuentes dadas, que quedan a distancia 0,
+	 * y rellena marked, edgeTo y distTo de los vrtices alcanzados (los
+	 * dems no se tocan).
+	 */
+	void recorre(const uint *fuentes, uint numFuentes,
+			bool *marked, uint *edgeTo, uint *distTo) {
+		_marked = marked;
+		_edgeTo = edgeTo;
+		_distTo = distTo;
+
+		uint64_t porMirar = 0;   // aristas de los vrtices sin visitar
+		for (uint v = 0; v < _V; ++v)
+			porMirar += _G.adj(v).numElems();
+
+		_cola.clear();
+		uint64_t deFrontera = 0;  // aristas que salen de la frontera
+		for (uint i = 0; i < numFuentes; ++i) {
+			uint s = fuentes[i];
+			if (reclama(s)) {
+				_marked[s] = true;
+				_distTo[s] = 0;
+				_cola.push_back(s);
+				deFrontera += _G.adj(s).numElems();
+			}
+		}
+
+		// En cada paso, las aristas de la frontera que se expande dejan
+		// de estar por mirar.
+		uint nivel = 0;
+		while (!_cola.empty()) {
+			if (deFrontera > porMirar / ALFA) {
+				colaABitmap();
+				std::size_t tam = _cola.size(), antes;
+				do {
+					antes = tam;
+					porMirar -= (deFrontera < porMirar) ? deFrontera : porMirar;
+					tam = ascendente(nivel++, deFrontera);
+				} while (tam >= antes || tam > _V / BETA);
+				bitmapACola();
+			} else {
+				porMirar -= (deFrontera < porMirar) ? deFrontera : porMirar;
+				deFrontera = descendente(nivel++);
+			}
+		}
+	}
+
+	BFSParalela(const BFSParalela &) = delete;
+	BFSParalela &operator=(const BFSParalela &) = delete;
+
+private:
+
+	/** Hilos que se usan para un paso con n vrtices de trabajo. */
+	uint hilosPara(std::size_t n) const {
+		std::size_t h = n / MIN_POR_HILO;
+		if (h < 1) h = 1;
+		return h < _numHilos ? (uint) h : _numHilos;
+	}
+
+	/** Ejecuta op(0), ..., op(n-1), cada uno en un hilo. */
+	template <class Op>
+	static void ejecuta(uint n, const Op &op) {
+		if (n == 1) {
+			op(0);
+			return;
+		}
+		std::vector<std::thread> hilos;
+		for (uint i = 1; i < n; ++i)
+			hilos.push_back(std::thread(op, i));
+		op(0);
+		for (std::size_t i = 0; i < hilos.size(); ++i)
+			hilos[i].join();
+	}
+
+	/** Marca v como visitado; devuelve false si ya lo estaba. */
+	bool reclama(uint v) {
+		std::atomic<uint64_t> &p = _visitados[v / 64];
+		uint64_t bit = (uint64_t) 1 << (v % 64);
+		if (p.load(std::memory_order_relaxed) & bit)
+			return false;
+		return (p.fetch_or(bit, std::memory_order_relaxed) & bit) == 0;
+	}
+
+	/**
+	 * Paso descendente desde los vrtices de _cola (a distancia nivel),
+	 * que pasa a contener los del nivel siguiente.
+	 * @return aristas que salen de la nueva frontera.
+	 */
+	uint64_t descendente(uint nivel) {
+		uint n = hilosPara(_cola.size());
+		std::vector<uint64_t> aristas(n, 0);
+		ejecuta(n, [&](uint h) {
+			std::vector<uint> &sig = _locales[h];
+			sig.clear();
+			uint64_t a = 0;
+			std::size_t ini = _cola.size() * h / n, fin = _cola.size() * (h + 1) / n;
+			for (std::size_t i = ini; i < fin; ++i) {
+				uint v = _cola[i];
+				for (uint w : _G.adj(v)) {
+					if (reclama(w)) {
+						_marked[w] = true;
+						_edgeTo[w] = v;
+						_distTo[w] = nivel + 1;
+						sig.push_back(w);
+						a += _G.adj(w).numElems();
+					}
+				}
+			}
+			aristas[h] = a;
+		});
+		_cola.clear();
+		uint64_t total = 0;
+		for (uint h = 0; h < n; ++h) {
+			_cola.insert(_cola.end(), _locales[h].begin(), _locales[h].end());
+			total += aristas[h];
+		}
+		return total;
+	}
+
+	/**
+	 * Paso ascendente desde los vrtices de _frontera (a distancia
+	 * nivel), que pasa a contener los del nivel siguiente.
+	 * @param aristas devuelve las aristas que salen de la nueva frontera.
+	 * @return nmero de vrtices de la nueva frontera.
+	 */
+	std::size_t ascendente(uint nivel, uint64_t &aristas) {
+		uint n = hilosPara(_V);
+		std::vector<std::size_t> encontrados(n, 0);
+		std::vector<uint64_t> salientes(n, 0);
+		ejecuta(n, [&](uint h) {
+			std::size_t cuenta = 0;
+			uint64_t a = 0;
+			std::size_t ini = _palabras * h / n, fin = _palabras * (h + 1) / n;
+			for (std::size_t i = ini; i < fin; ++i) {
+				uint64_t vis = _visitados[i].load(std::memory_order_relaxed);
+				uint64_t sig = 0;
+				for (uint b = 0; b < 64 && i * 64 + b < _V; ++b) {
+					uint64_t bit = (uint64_t) 1 << b;
+					if (vis & bit)
+						continue;
+					uint v = (uint) (i * 64 + b);
+					for (uint u : _inv.adj(v)) {
+						if (_frontera[u / 64] & ((uint64_t) 1 << (u % 64))) {
+							_marked[v] = true;
+							_edgeTo[v] = u;
+							_distTo[v] = nivel + 1;
+							sig |= bit;
+							++cuenta;
+							a += _G.adj(v).numElems();
+							break;
+						}
+					}
+				}
+				_visitados[i].store(vis | sig, std::memory_order_relaxed);
+				_siguiente[i] = sig;
+			}
+			encontrados[h] = cuenta;
+			salientes[h] = a;
+		});
+		std::swap(_frontera, _siguiente);
+		std::size_t total = 0;
+		aristas = 0;
+		for (uint h = 0; h < n; ++h) {
+			total += encontrados[h];
+			aristas += salientes[h];
+		}
+		return total;
+	}
+
+	/** Pasa la frontera de _cola a _frontera. */
+	void colaABitmap() {
+		for (std::size_t i = 0; i < _palabras; ++i)
+			_frontera[i] = 0;
+		for (std::size_t i = 0; i < _cola.size(); ++i)
+			_frontera[_cola[i] / 64] |= (uint64_t) 1 << (_cola[i] % 64);
+	}
+
+	/** Pasa la frontera de _frontera a _cola. */
+	void bitmapACola() {
+		_cola.clear();
+		for (std::size_t i = 0; i < _palabras; ++i)
+			if (_frontera[i] != 0)
+				for (uint b = 0; b < 64; ++b)
+					if (_frontera[i] & ((uint64_t) 1 << b))
+						_cola.push_back((uint) (i * 64 + b));
+	}
+
+	const TipoGrafo &_G;
+	const TipoInverso &_inv;
+	uint _V;                           // nmero de vrtices
+	std::size_t _palabras;             // palabras de cada bitmap
+	uint _numHilos;                    // hilos como mximo
+
+	std::atomic<uint64_t> *_visitados; // bitmap de vrtices alcanzados
+	uint64_t *_frontera;               // frontera en los pasos ascendentes
+	uint64_t *_siguiente;              // frontera que se est formando
+	std::vector<uint> _cola;           // frontera en los pasos descendentes
+	std::vector<uint> *_locales;       // nueva frontera de cada hilo
+
+	bool *_marked;
+	uint *_edgeTo;
+	uint *_distTo;
+};
+
+#endif /* BFSPARALELA_H_ */
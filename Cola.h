@@ -14,6 +14,11 @@
 #define __COLA_LISTA_ENLAZADA_H
 
 #include "Excepciones.h"
+#include "PoolNodos.h"
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <utility>
 
 /**
  Implementacin del TAD Cola utilizando una lista enlazada.
@@ -23,6 +28,7 @@
  - ColaVacia: -> Cola. Generadora implementada en el
    constructor sin parmetros.
  - PonDetras: Cola, Elem -> Cola. Generadora
+   (tambin emplazaDetras, que construye el elemento en la cola)
  - quitaPrim: Cola - -> Cola. Modificadora parcial.
  - primero: Cola - -> Elem. Observadora parcial.
  - esVacia: Cola -> Bool. Observadora.
@@ -32,10 +38,32 @@
  */
 template <class T>
 class Cola {
+private:
+	class Nodo;
+
 public:
 
+	/**
+	 Almacn del que pueden sacar sus nodos varias colas
+	 (ver PoolNodos.h). Los nodos que se liberan en una de
+	 ellas se reutilizan en cualquiera, y toda la memoria se
+	 devuelve de golpe al destruir el almacn, que debe
+	 vivir ms que las colas que lo usan. No se puede usar
+	 desde varios hilos a la vez.
+	 */
+	typedef PoolNodos<Nodo> Almacen;
+
 	/** Constructor; operacion ColaVacia */
-	Cola() : _prim(NULL), _ult(NULL), _numElems(0) {
+	Cola() : _prim(NULL), _ult(NULL), _numElems(0), _almacen(NULL) {
+	}
+
+	/**
+	 Constructor; operacin ColaVacia. Los nodos de la cola
+	 saldrn del almacn dado en lugar de pedirse uno a uno
+	 con new.
+	 */
+	explicit Cola(Almacen &almacen) : _prim(NULL), _ult(NULL),
+			_numElems(0), _almacen(&almacen) {
 	}
 
 	/** Destructor; elimina la lista enlazada. */
@@ -51,16 +79,21 @@ public:
 	 @param elem Elemento a aadir.
 	*/
 	void ponDetras(const T &elem) {
-		Nodo *nuevo = new Nodo(elem, NULL);
+		ponDetrasAux(elem);
+	}
 
-		if (_ult != NULL)
-			_ult->_sig = nuevo;
-		_ult = nuevo;
-		// Si la cola estaba vaca, el primer elemento
-		// es el que acabamos de aadir
-		if (_prim == NULL)
-			_prim = nuevo;
-		_numElems++;
+	/** Igual que el anterior, pero mueve el elemento a la
+	    cola en lugar de copiarlo. */
+	void ponDetras(T &&elem) {
+		ponDetrasAux(std::move(elem));
+	}
+
+	/** Aade en la parte trasera de la cola un elemento
+	    construido directamente en su nodo a partir de
+	    "args". */
+	template <class... Args>
+	void emplazaDetras(Args&&... args) {
+		ponDetrasAux(std::forward<Args>(args)...);
 	}
 
 	/**
@@ -77,7 +110,7 @@ public:
 			throw EColaVacia();
 		Nodo *aBorrar = _prim;
 		_prim = _prim->_sig;
-		delete aBorrar;
+		destruyeNodo(aBorrar);
 		--_numElems;
 		// Si la cola se qued vaca, no hay
 		// ltimo
@@ -125,16 +158,86 @@ public:
 		return _numElems;
 	}
 
+	/**
+	 Iterador de avance de la STL que recorre la cola desde
+	 el primer elemento hasta el ltimo sin modificarla, por
+	 ejemplo en un for de rango. Slo comprueba con assert
+	 que no se salga de la cola.
+	 */
+	class Iterador {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const T *pointer;
+		typedef const T &reference;
+
+		Iterador() : _act(NULL) {}
+
+		const T &operator*() const {
+			assert(_act != NULL);
+			return _act->_elem;
+		}
+
+		const T *operator->() const {
+			return &operator*();
+		}
+
+		Iterador &operator++() {
+			assert(_act != NULL);
+			_act = _act->_sig;
+			return *this;
+		}
+
+		Iterador operator++(int) {
+			Iterador ret(*this);
+			operator++();
+			return ret;
+		}
+
+		bool operator==(const Iterador &other) const {
+			return _act == other._act;
+		}
+
+		bool operator!=(const Iterador &other) const {
+			return !(this->operator==(other));
+		}
+	private:
+		friend class Cola;
+
+		Iterador(Nodo *act) : _act(act) {}
+
+		// Nodo actual del recorrido (NULL al final)
+		Nodo *_act;
+	};
+
+	/** @return iterador al primer elemento de la cola. */
+	Iterador begin() const {
+		return Iterador(_prim);
+	}
+
+	/** @return iterador al final del recorrido (fuera de ste). */
+	Iterador end() const {
+		return Iterador(NULL);
+	}
+
 	// //
 	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
 	// A LA CLASE
 	// //
 
 	/** Constructor copia */
-	Cola(const Cola<T> &other) : _prim(NULL), _ult(NULL) {
+	Cola(const Cola<T> &other) : _prim(NULL), _ult(NULL), _almacen(NULL) {
 		copia(other);
 	}
 
+	/** Constructor de movimiento: se queda con los nodos de
+	    other (y con su almacn), y other queda vaca. */
+	Cola(Cola<T> &&other) : _prim(NULL), _ult(NULL), _numElems(0),
+			_almacen(other._almacen) {
+		trasladaDe(other);
+	}
+
 	/** Operador de asignacin */
 	Cola<T> &operator=(const Cola<T> &other) {
 		if (this != &other) {
@@ -144,6 +247,17 @@ public:
 		return *this;
 	}
 
+	/** Asignacin de movimiento. La cola conserva su almacn. */
+	Cola<T> &operator=(Cola<T> &&other) {
+		if (this != &other) {
+			libera();
+			_prim = _ult = NULL;
+			_numElems = 0;
+			trasladaDe(other);
+		}
+		return *this;
+	}
+
 	/** Operador de comparacin. */
 	bool operator==(const Cola<T> &rhs) const {
 		if (_numElems != rhs._numElems)
@@ -170,6 +284,27 @@ protected:
 		libera(_prim);
 	}
 
+	/**
+	 Pasa a esta cola, que debe estar vaca, los elementos de
+	 other, que queda vaca. Si las dos usan el mismo almacn
+	 se pasan los nodos tal cual; si no, los elementos se
+	 mueven a nodos nuevos.
+	 */
+	void trasladaDe(Cola &other) {
+		if (_almacen == other._almacen) {
+			_prim = other._prim;
+			_ult = other._ult;
+			_numElems = other._numElems;
+			other._prim = other._ult = NULL;
+			other._numElems = 0;
+		} else {
+			while (!other.esVacia()) {
+				ponDetras(std::move(other._prim->_elem));
+				other.quitaPrim();
+			}
+		}
+	}
+
 	void copia(const Cola &other) {
 
 		if (other.esVacia()) {
@@ -178,11 +313,11 @@ protected:
 		} else {
 			Nodo *act = other._prim;
 			Nodo *ant;
-			_prim = new Nodo(act->_elem);
+			_prim = creaNodo(act->_elem);
 			ant = _prim;
 			while (act->_sig != NULL) {
 				act = act->_sig;
-				ant->_sig = new Nodo(act->_elem);
+				ant->_sig = creaNodo(act->_elem);
 				ant = ant->_sig;
 			}
 			_ult = ant;
@@ -204,6 +339,12 @@ private:
 		Nodo(const T &elem, Nodo *sig) : 
 		    _elem(elem), _sig(sig) {}
 
+		// Construye el elemento a partir de "args" directamente
+		// dentro del nodo.
+		template <class... Args>
+		Nodo(Nodo *sig, Args&&... args) :
+		    _elem(std::forward<Args>(args)...), _sig(sig) {}
+
 		T _elem;
 		Nodo *_sig;
 	};
@@ -213,15 +354,57 @@ private:
 	 primer nodo se pasa como parmetro.
 	 Se admite que el nodo sea NULL (no habr nada que
 	 liberar).
+	 Tambin con almacn se recorren los nodos uno a uno:
+	 cada hueco tiene que volver a la lista de libres para
+	 que lo reutilicen las dems colas, y slo al destruir
+	 el almacn se devuelve la memoria de golpe.
 	 */
-	static void libera(Nodo *prim) {
+	void libera(Nodo *prim) {
 		while (prim != NULL) {
 			Nodo *aux = prim;
 			prim = prim->_sig;
-			delete aux;
+			destruyeNodo(aux);
 		}
 	}
 
+	/**
+	 Aade al final de la cola un elemento construido a
+	 partir de "args" (implementacin de ponDetras y
+	 emplazaDetras).
+	 */
+	template <class... Args>
+	void ponDetrasAux(Args&&... args) {
+		Nodo *nuevo = creaNodo((Nodo *) NULL, std::forward<Args>(args)...);
+
+		if (_ult != NULL)
+			_ult->_sig = nuevo;
+		_ult = nuevo;
+		// Si la cola estaba vaca, el primer elemento
+		// es el que acabamos de aadir
+		if (_prim == NULL)
+			_prim = nuevo;
+		_numElems++;
+	}
+
+	/**
+	 Crea un nodo con los argumentos dados, en el almacn de
+	 la cola si tiene uno.
+	 */
+	template <class... Args>
+	Nodo *creaNodo(Args&&... args) {
+		if (_almacen != NULL)
+			return _almacen->crea(std::forward<Args>(args)...);
+		return new Nodo(std::forward<Args>(args)...);
+	}
+
+	/** Destruye un nodo creado con creaNodo. */
+	void destruyeNodo(Nodo *n) {
+		if (_almacen != NULL)
+			_almacen->destruye(n);
+		else
+			delete n;
+	}
+
 	/** Puntero al primer elemento. */
 	Nodo *_prim;
 
@@ -230,6 +413,9 @@ private:
 
 	/** Nmero de elementos */
 	int _numElems;
+
+	/** Almacn del que salen los nodos (NULL si se usa new). */
+	Almacen *_almacen;
 };
 
 #endif // __PILA_LISTA_ENLAZADA_H
@@ -0,0 +1,480 @@
+/**
+  @file ColaCircular.h
+
+  Implementacin de los TADs Cola y Doble Cola utilizando
+  un vector circular que crece por potencias de dos.
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __COLA_CIRCULAR_H
+#define __COLA_CIRCULAR_H
+
+#include "Excepciones.h"
+#include "Traslado.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iterator>
+#include <new>
+#include <utility>
+
+/**
+ Implementacin del TAD Doble Cola utilizando un vector
+ circular. Los elementos estn seguidos en memoria (como
+ mucho en dos tramos, cuando dan la vuelta al final del
+ vector), as que poner y quitar elementos no reserva
+ memoria salvo cuando el vector se llena, y los recorridos
+ aprovechan la cach. El tamao del vector es siempre una
+ potencia de dos para calcular las posiciones con una
+ mscara, y se dobla cuando se llena.
+
+ Las operaciones son las de DCola:
+
+ - DColaVacia: -> DCola. Generadora implementada en el
+   constructor sin parmetros.
+ - PonDetras: DCola, Elem -> DCola. Generadora
+ - ponDelante: DCola, Elem -> DCola. Modificadora.
+ - quitaPrim: DCola - -> DCola. Modificadora parcial
+ - primero: DCola - -> Elem. Observadora parcial
+ - quitaUlt: DCola - -> DCola. Modificadora parcial
+ - ultimo: DCola - -> Elem. Observadora parcial
+ - esVacia: DCola -> Bool. Observadora
+ - numElems: DCola -> Entero. Observadora
+
+ Adems tiene emplazaDetras y emplazaDelante, que construyen
+ el elemento en su sitio, operaciones para poner y quitar
+ muchos elementos de una vez (ponDetrasTodos, extraePrim y
+ quitaPrim(n)), acceso por posicin (elem) y reserva.
+ */
+template <class T>
+class DColaCircular {
+public:
+
+	/** Tamao inicial del vector (potencia de dos). */
+	enum { TAM_INICIAL = 16 };
+
+	/** Constructor; operacin DColaVacia. No reserva memoria
+	    hasta que se aade el primer elemento. */
+	DColaCircular() : _v(NULL), _tam(0), _ini(0), _numElems(0) {
+	}
+
+	/** Destructor; elimina el vector. */
+	~DColaCircular() {
+		libera();
+	}
+
+	/**
+	 Aade un elemento por la parte de atrs de la cola.
+	 Es una operacin generadora.
+	*/
+	void ponDetras(const T &e) {
+		emplazaDetras(e);
+	}
+
+	void ponDetras(T &&e) {
+		emplazaDetras(std::move(e));
+	}
+
+	/** Aade por detrs un elemento construido directamente
+	    en su posicin a partir de "args". */
+	template <class... Args>
+	void emplazaDetras(Args&&... args) {
+		if (_numElems == _tam) {
+			// args puede referirse a un elemento de la cola, que
+			// dejar de ser vlido en cuanto amplia cambie de vector.
+			T elem(std::forward<Args>(args)...);
+			amplia(_numElems + 1);
+			new (hueco(_numElems)) T(std::move(elem));
+		} else
+			new (hueco(_numElems)) T(std::forward<Args>(args)...);
+		_numElems++;
+	}
+
+	/**
+	 Aade un elemento a la parte delantera de la doble cola.
+	 Operacin modificadora.
+	 */
+	void ponDelante(const T &e) {
+		emplazaDelante(e);
+	}
+
+	void ponDelante(T &&e) {
+		emplazaDelante(std::move(e));
+	}
+
+	/** Aade por delante un elemento construido directamente
+	    en su posicin a partir de "args". */
+	template <class... Args>
+	void emplazaDelante(Args&&... args) {
+		if (_numElems == _tam) {
+			// Como en emplazaDetras.
+			T elem(std::forward<Args>(args)...);
+			amplia(_numElems + 1);
+			unsigned int ini = (_ini - 1) & (_tam - 1);
+			new (&_v[ini]) T(std::move(elem));
+			_ini = ini;
+		} else {
+			unsigned int ini = (_ini - 1) & (_tam - 1);
+			new (&_v[ini]) T(std::forward<Args>(args)...);
+			_ini = ini;
+		}
+		_numElems++;
+	}
+
+	/**
+	 Aade por detrs, en orden, todos los elementos del
+	 intervalo [ini, fin). El vector crece como mucho una
+	 vez, antes de empezar.
+	 @param ini iterador (o puntero) al primer elemento.
+	 @param fin iterador (o puntero) al final del intervalo.
+	 */
+	template <class It>
+	void ponDetrasTodos(It ini, It fin) {
+		reserva(_numElems + (unsigned int) std::distance(ini, fin));
+		for (; ini != fin; ++ini) {
+			new (hueco(_numElems)) T(*ini);
+			_numElems++;
+		}
+	}
+
+	/**
+	 Devuelve el primer elemento de la cola; es un error
+	 preguntar por el primer elemento de una doble cola vaca.
+	 */
+	const T &primero() const {
+		if (esVacia())
+			throw EDColaVacia();
+		return _v[_ini];
+	}
+
+	/**
+	 Devuelve el ltimo elemento de la doble cola. Es
+	 un error preguntar por el ltimo de una doble cola vaca.
+	 */
+	const T &ultimo() const {
+		if (esVacia())
+			throw EDColaVacia();
+		return *hueco(_numElems - 1);
+	}
+
+	/**
+	 Elimina el primer elemento de la doble cola. Es un error
+	 quitar el primero de una doble cola vaca.
+	*/
+	void quitaPrim() {
+		if (esVacia())
+			throw EDColaVacia();
+		_v[_ini].~T();
+		_ini = (_ini + 1) & (_tam - 1);
+		_numElems--;
+	}
+
+	/**
+	 Elimina los n primeros elementos de la doble cola (todos,
+	 si tiene menos).
+	 @param n nmero de elementos a eliminar.
+	 */
+	void quitaPrim(unsigned int n) {
+		if (n > _numElems)
+			n = _numElems;
+		for (unsigned int i = 0; i < n; ++i)
+			hueco(i)->~T();
+		if (n > 0)
+			_ini = (_ini + n) & (_tam - 1);
+		_numElems -= n;
+	}
+
+	/**
+	 Mueve a dest los n primeros elementos (o todos, si hay
+	 menos) y los elimina de la doble cola.
+	 @param dest iterador (o puntero) de salida.
+	 @param n nmero mximo de elementos a extraer.
+	 @return nmero de elementos extrados.
+	 */
+	template <class It>
+	unsigned int extraePrim(It dest, unsigned int n) {
+		if (n > _numElems)
+			n = _numElems;
+		for (unsigned int i = 0; i < n; ++i, ++dest)
+			*dest = std::move(*hueco(i));
+		quitaPrim(n);
+		return n;
+	}
+
+	/**
+	 Elimina el ltimo elemento de la doble cola. Es
+	 un error quitar el ltimo de una doble cola vaca.
+	 */
+	void quitaUlt() {
+		if (esVacia())
+			throw EDColaVacia();
+		hueco(_numElems - 1)->~T();
+		_numElems--;
+	}
+
+	/**
+	 Devuelve el elemento i-simo, con i en [0..numElems()-1]
+	 (el 0 es el primero). Coste constante.
+	 */
+	const T &elem(unsigned int i) const {
+		if (i >= _numElems)
+			throw EAccesoInvalido();
+		return *hueco(i);
+	}
+
+	/**
+	 @return true si la doble cola no tiene elementos.
+	 */
+	bool esVacia() const {
+		return _numElems == 0;
+	}
+
+	/**
+	 @return Nmero de elementos.
+	 */
+	int numElems() const {
+		return _numElems;
+	}
+
+	/**
+	 Prepara el vector para guardar n elementos sin volver
+	 a crecer.
+	 */
+	void reserva(unsigned int n) {
+		if (n > _tam)
+			amplia(n);
+	}
+
+	// //
+	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
+	// A LA CLASE
+	// //
+
+	/** Constructor copia */
+	DColaCircular(const DColaCircular<T> &other) :
+			_v(NULL), _tam(0), _ini(0), _numElems(0) {
+		copia(other);
+	}
+
+	/** Constructor de movimiento: se queda con el vector de
+	    other, que queda vaca. */
+	DColaCircular(DColaCircular<T> &&other) : _v(other._v),
+			_tam(other._tam), _ini(other._ini), _numElems(other._numElems) {
+		other._v = NULL;
+		other._tam = other._ini = other._numElems = 0;
+	}
+
+	/** Operador de asignacin */
+	DColaCircular<T> &operator=(const DColaCircular<T> &other) {
+		if (this != &other) {
+			libera();
+			copia(other);
+		}
+		return *this;
+	}
+
+	/** Asignacin de movimiento */
+	DColaCircular<T> &operator=(DColaCircular<T> &&other) {
+		if (this != &other) {
+			libera();
+			_v = other._v;
+			_tam = other._tam;
+			_ini = other._ini;
+			_numElems = other._numElems;
+			other._v = NULL;
+			other._tam = other._ini = other._numElems = 0;
+		}
+		return *this;
+	}
+
+	/** Operador de comparacin. */
+	bool operator==(const DColaCircular<T> &rhs) const {
+		if (_numElems != rhs._numElems)
+			return false;
+		for (unsigned int i = 0; i < _numElems; ++i)
+			if (*hueco(i) != *rhs.hueco(i))
+				return false;
+		return true;
+	}
+
+	bool operator!=(const DColaCircular<T> &rhs) const {
+		return !(*this == rhs);
+	}
+
+protected:
+
+	void libera() {
+		quitaPrim(_numElems);
+		free(_v);
+		_v = NULL;
+		_tam = _ini = 0;
+	}
+
+	void copia(const DColaCircular<T> &other) {
+		_v = NULL;
+		_tam = _ini = _numElems = 0;
+		reserva(other._numElems);
+		for (unsigned int i = 0; i < other._numElems; ++i) {
+			new (hueco(i)) T(*other.hueco(i));
+			_numElems++;
+		}
+	}
+
+private:
+
+	/**
+	 Devuelve la direccin de la posicin i-sima contando
+	 desde el primer elemento (puede estar libre).
+	 */
+	T *hueco(unsigned int i) const {
+		return &_v[(_ini + i) & (_tam - 1)];
+	}
+
+	/**
+	 Cambia el vector por otro con sitio para al menos n
+	 elementos (la menor potencia de dos, y como poco
+	 TAM_INICIAL), moviendo a l los elementos, que quedan
+	 a partir de la posicin 0.
+	 */
+	void amplia(unsigned int n) {
+		unsigned int tam = (_tam == 0) ? (unsigned int) TAM_INICIAL : _tam;
+		while (tam < n)
+			tam *= 2;
+
+		T *nuevo = static_cast<T *>(malloc(tam * sizeof(T)));
+		if (nuevo == NULL)
+			throw std::bad_alloc();
+
+		// Los elementos ocupan como mucho dos tramos contiguos:
+		// de _ini al final de _v y del principio de _v en adelante.
+		unsigned int primero = std::min(_numElems, _tam - _ini);
+		trasladaElems(nuevo, _v + _ini, primero);
+		trasladaElems(nuevo + primero, _v, _numElems - primero);
+
+		free(_v);
+		_v = nuevo;
+		_tam = tam;
+		_ini = 0;
+	}
+
+	/** Vector circular (sin construir en las posiciones libres). */
+	T *_v;
+
+	/** Tamao de _v (0 o una potencia de dos). */
+	unsigned int _tam;
+
+	/** Posicin del primer elemento. */
+	unsigned int _ini;
+
+	/** Nmero de elementos. */
+	unsigned int _numElems;
+};
+
+
+/**
+ Implementacin del TAD Cola sobre una doble cola circular
+ (DColaCircular). Tiene las mismas operaciones que Cola,
+ adems de las de insercin y extraccin en bloque.
+
+ Las operaciones son:
+
+ - ColaVacia: -> Cola. Generadora implementada en el
+   constructor sin parmetros.
+ - PonDetras: Cola, Elem -> Cola. Generadora
+ - quitaPrim: Cola - -> Cola. Modificadora parcial.
+ - primero: Cola - -> Elem. Observadora parcial.
+ - esVacia: Cola -> Bool. Observadora.
+ - numElems: Cola -> Entero. Observadora.
+ */
+template <class T>
+class ColaCircular {
+public:
+
+	/**
+	 Aade un elemento en la parte trasera de la cola.
+	 Operacin generadora.
+	*/
+	void ponDetras(const T &elem) {
+		_d.ponDetras(elem);
+	}
+
+	void ponDetras(T &&elem) {
+		_d.ponDetras(std::move(elem));
+	}
+
+	template <class... Args>
+	void emplazaDetras(Args&&... args) {
+		_d.emplazaDetras(std::forward<Args>(args)...);
+	}
+
+	/** Aade por detrs todos los elementos de [ini, fin). */
+	template <class It>
+	void ponDetrasTodos(It ini, It fin) {
+		_d.ponDetrasTodos(ini, fin);
+	}
+
+	/**
+	 Elimina el primer elemento de la cola. Operacin
+	 modificadora parcial, que falla si la cola est vaca.
+	*/
+	void quitaPrim() {
+		if (esVacia())
+			throw EColaVacia();
+		_d.quitaPrim();
+	}
+
+	/** Elimina los n primeros elementos (o todos si hay menos). */
+	void quitaPrim(unsigned int n) {
+		_d.quitaPrim(n);
+	}
+
+	/** Mueve a dest hasta n elementos del principio de la cola
+	    y los elimina de ella. @return nmero de elementos. */
+	template <class It>
+	unsigned int extraePrim(It dest, unsigned int n) {
+		return _d.extraePrim(dest, n);
+	}
+
+	/**
+	 Devuelve el primer elemento de la cola. Operacin
+	 observadora parcial, que falla si la cola est vaca.
+	 */
+	const T &primero() const {
+		if (esVacia())
+			throw EColaVacia();
+		return _d.primero();
+	}
+
+	/** @return true si la cola no tiene ningn elemento. */
+	bool esVacia() const {
+		return _d.esVacia();
+	}
+
+	/** @return Nmero de elementos. */
+	int numElems() const {
+		return _d.numElems();
+	}
+
+	/** Prepara la cola para guardar n elementos sin crecer. */
+	void reserva(unsigned int n) {
+		_d.reserva(n);
+	}
+
+	/** Operador de comparacin. */
+	bool operator==(const ColaCircular<T> &rhs) const {
+		return _d == rhs._d;
+	}
+
+	bool operator!=(const ColaCircular<T> &rhs) const {
+		return !(*this == rhs);
+	}
+
+private:
+
+	/** Doble cola en la que se guardan los elementos. */
+	DColaCircular<T> _d;
+};
+
+#endif // __COLA_CIRCULAR_H
@@ -0,0 +1,343 @@
+/**
+  @file ColaConcurrente.h
+
+  Implementacin del TAD Cola para pasar elementos entre
+  hilos sin cerrojos, sobre un vector circular de tamao
+  fijo.
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __COLA_CONCURRENTE_H
+#define __COLA_CONCURRENTE_H
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ Cola acotada para un nico hilo productor (el nico que
+ llama a tryPonDetras) y un nico hilo consumidor (el nico
+ que llama a tryQuitaPrim), sin cerrojos. Cada hilo slo
+ escribe su propio ndice y guarda una copia del ndice del
+ otro, que slo vuelve a leer cuando la cola le parece llena
+ (o vaca); as, mientras hay sitio y elementos, los dos
+ hilos apenas comparten lneas de cach.
+
+ Como las operaciones de Cola lanzan excepciones cuando la
+ cola est vaca, aqu se sustituyen por versiones que
+ devuelven si han podido hacer su trabajo:
+
+ - ColaVacia: Entero -> Cola. Generadora (constructor, con
+   el nmero mximo de elementos).
+ - tryPonDetras: Cola, Elem -> Cola, Bool. Generadora; falla
+   (devuelve false) si la cola est llena.
+ - tryQuitaPrim: Cola -> Cola, Elem, Bool. Modificadora;
+   falla (devuelve false) si la cola est vaca.
+ - esVacia: Cola -> Bool. Observadora.
+ - numElems: Cola -> Entero. Observadora.
+
+ Si la cola se usa desde otros hilos, esVacia y numElems
+ pueden haber dejado de ser ciertas al devolverlas.
+ */
+template <class T>
+class ColaSPSC {
+public:
+
+	/**
+	 Constructor; operacin ColaVacia.
+	 @param capacidad nmero mximo de elementos; se redondea
+	 a la siguiente potencia de dos.
+	 */
+	explicit ColaSPSC(unsigned int capacidad) :
+			_cabeza(0), _colaCache(0), _cola(0), _cabezaCache(0) {
+		_tam = 1;
+		while (_tam < capacidad)
+			_tam *= 2;
+		_mascara = _tam - 1;
+		_v = new Hueco[_tam];
+	}
+
+	/** Destructor. Ningn otro hilo puede estar usando la cola. */
+	~ColaSPSC() {
+		std::size_t fin = _cola.load(std::memory_order_relaxed);
+		for (std::size_t i = _cabeza.load(std::memory_order_relaxed);
+				i != fin; ++i)
+			elem(i).~T();
+		delete[] _v;
+	}
+
+	/**
+	 Aade un elemento por detrs de la cola. Slo la puede
+	 llamar el hilo productor.
+	 @return false si la cola estaba llena (y no se ha aadido).
+	 */
+	bool tryPonDetras(const T &e) {
+		return tryEmplazaDetras(e);
+	}
+
+	bool tryPonDetras(T &&e) {
+		return tryEmplazaDetras(std::move(e));
+	}
+
+	/** Como tryPonDetras, construyendo el elemento en su sitio. */
+	template <class... Args>
+	bool tryEmplazaDetras(Args&&... args) {
+		std::size_t cola = _cola.load(std::memory_order_relaxed);
+		if (cola - _cabezaCache == _tam) {
+			_cabezaCache = _cabeza.load(std::memory_order_acquire);
+			if (cola - _cabezaCache == _tam)
+				return false;
+		}
+		new (&_v[cola & _mascara]) T(std::forward<Args>(args)...);
+		_cola.store(cola + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 Quita el primer elemento de la cola y lo mueve a "e".
+	 Slo la puede llamar el hilo consumidor.
+	 @return false si la cola estaba vaca ("e" no cambia).
+	 */
+	bool tryQuitaPrim(T &e) {
+		std::size_t cabeza = _cabeza.load(std::memory_order_relaxed);
+		if (cabeza == _colaCache) {
+			_colaCache = _cola.load(std::memory_order_acquire);
+			if (cabeza == _colaCache)
+				return false;
+		}
+		T &prim = elem(cabeza);
+		e = std::move(prim);
+		prim.~T();
+		_cabeza.store(cabeza + 1, std::memory_order_release);
+		return true;
+	}
+
+	/** @return true si la cola no tiene elementos. */
+	bool esVacia() const {
+		return numElems() == 0;
+	}
+
+	/** @return Nmero de elementos. */
+	int numElems() const {
+		std::size_t cabeza = _cabeza.load(std::memory_order_acquire);
+		return (int) (_cola.load(std::memory_order_acquire) - cabeza);
+	}
+
+	/** @return Nmero mximo de elementos. */
+	int capacidad() const {
+		return (int) _tam;
+	}
+
+	// Un hilo podra estar usando la cola original mientras se
+	// copia, as que no se puede copiar.
+	ColaSPSC(const ColaSPSC &) = delete;
+	ColaSPSC &operator=(const ColaSPSC &) = delete;
+
+private:
+
+	typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Hueco;
+
+	T &elem(std::size_t i) {
+		return *reinterpret_cast<T *>(&_v[i & _mascara]);
+	}
+
+	// Los rellenos (64 bytes, el tamao habitual de una lnea de
+	// cach) separan los datos que escribe cada hilo.
+
+	// Datos que no cambian despus del constructor.
+	Hueco *_v;               ///< Vector circular.
+	std::size_t _tam;        ///< Tamao de _v (potencia de dos).
+	std::size_t _mascara;    ///< _tam - 1.
+	char _relleno0[64];
+
+	// Datos del consumidor.
+	std::atomic<std::size_t> _cabeza; ///< Posicin (sin reducir) del primero.
+	std::size_t _colaCache;           ///< ltimo valor ledo de _cola.
+	char _relleno1[64];
+
+	// Datos del productor.
+	std::atomic<std::size_t> _cola;   ///< Posicin (sin reducir) tras el ltimo.
+	std::size_t _cabezaCache;         ///< ltimo valor ledo de _cabeza.
+	char _relleno2[64];
+};
+
+
+/**
+ Cola acotada que pueden usar a la vez varios hilos
+ productores y varios consumidores, sin cerrojos. Cada
+ posicin del vector circular tiene un nmero de secuencia
+ que indica si est libre para la vuelta actual de los
+ productores o tiene un elemento listo para los
+ consumidores; los hilos se reparten las posiciones
+ incrementando (con compare-and-swap) el ndice de su lado,
+ de manera que productores y consumidores slo compiten
+ entre ellos por ese ndice y no por los datos.
+
+ Las operaciones son las mismas que las de ColaSPSC:
+
+ - ColaVacia: Entero -> Cola. Generadora (constructor).
+ - tryPonDetras: Cola, Elem -> Cola, Bool. Generadora; falla
+   (devuelve false) si la cola est llena.
+ - tryQuitaPrim: Cola -> Cola, Elem, Bool. Modificadora;
+   falla (devuelve false) si la cola est vaca.
+ - esVacia: Cola -> Bool. Observadora.
+ - numElems: Cola -> Entero. Observadora.
+
+ Si la cola se usa desde otros hilos, esVacia y numElems
+ pueden haber dejado de ser ciertas al devolverlas.
+
+ Una posicin se reserva antes de escribir o leer en ella, y
+ ya no se puede devolver; por eso mover un T no puede lanzar
+ excepciones (si lo hiciera, la posicin no se publicara
+ nunca y los dems hilos se quedaran esperndola).
+ */
+template <class T>
+class ColaMPMC {
+	static_assert(std::is_nothrow_move_constructible<T>::value &&
+			std::is_nothrow_move_assignable<T>::value,
+			"ColaMPMC necesita que mover un T no lance excepciones");
+public:
+
+	/**
+	 Constructor; operacin ColaVacia.
+	 @param capacidad nmero mximo de elementos; se redondea
+	 a la siguiente potencia de dos (y al menos 2).
+	 */
+	explicit ColaMPMC(unsigned int capacidad) :
+			_poner(0), _quitar(0) {
+		_tam = 2;
+		while (_tam < capacidad)
+			_tam *= 2;
+		_mascara = _tam - 1;
+		_v = new Celda[_tam];
+		for (std::size_t i = 0; i < _tam; ++i)
+			_v[i]._sec.store(i, std::memory_order_relaxed);
+	}
+
+	/** Destructor. Ningn otro hilo puede estar usando la cola. */
+	~ColaMPMC() {
+		std::size_t fin = _poner.load(std::memory_order_relaxed);
+		for (std::size_t i = _quitar.load(std::memory_order_relaxed);
+				i != fin; ++i)
+			_v[i & _mascara].elem().~T();
+		delete[] _v;
+	}
+
+	/**
+	 Aade un elemento por detrs de la cola.
+	 @return false si la cola estaba llena (y no se ha aadido).
+	 */
+	bool tryPonDetras(const T &e) {
+		return tryEmplazaDetras(e);
+	}
+
+	bool tryPonDetras(T &&e) {
+		return tryEmplazaDetras(std::move(e));
+	}
+
+	/** Como tryPonDetras, construyendo el elemento a partir de "args". */
+	template <class... Args>
+	bool tryEmplazaDetras(Args&&... args) {
+		// El constructor de T s puede lanzar, as que el elemento
+		// se construye antes de reservar la posicin.
+		T elem(std::forward<Args>(args)...);
+		Celda *c;
+		std::size_t pos = _poner.load(std::memory_order_relaxed);
+		for (;;) {
+			c = &_v[pos & _mascara];
+			std::size_t sec = c->_sec.load(std::memory_order_acquire);
+			std::ptrdiff_t dif = (std::ptrdiff_t) sec - (std::ptrdiff_t) pos;
+			if (dif == 0) {
+				// Libre en esta vuelta: intentamos quedrnosla.
+				if (_poner.compare_exchange_weak(pos, pos + 1,
+						std::memory_order_relaxed))
+					break;
+			} else if (dif < 0)
+				// Todava tiene el elemento de la vuelta anterior.
+				return false;
+			else
+				// Otro productor se nos ha adelantado.
+				pos = _poner.load(std::memory_order_relaxed);
+		}
+		new (&c->_dato) T(std::move(elem));
+		c->_sec.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 Quita el primer elemento de la cola y lo mueve a "e".
+	 @return false si la cola estaba vaca ("e" no cambia).
+	 */
+	bool tryQuitaPrim(T &e) {
+		Celda *c;
+		std::size_t pos = _quitar.load(std::memory_order_relaxed);
+		for (;;) {
+			c = &_v[pos & _mascara];
+			std::size_t sec = c->_sec.load(std::memory_order_acquire);
+			std::ptrdiff_t dif = (std::ptrdiff_t) sec - (std::ptrdiff_t) (pos + 1);
+			if (dif == 0) {
+				if (_quitar.compare_exchange_weak(pos, pos + 1,
+						std::memory_order_relaxed))
+					break;
+			} else if (dif < 0)
+				return false;
+			else
+				pos = _quitar.load(std::memory_order_relaxed);
+		}
+		e = std::move(c->elem());
+		c->elem().~T();
+		// Queda libre para la siguiente vuelta de los productores.
+		c->_sec.store(pos + _tam, std::memory_order_release);
+		return true;
+	}
+
+	/** @return true si la cola no tiene elementos. */
+	bool esVacia() const {
+		return numElems() == 0;
+	}
+
+	/** @return Nmero de elementos (aproximado si hay otros hilos). */
+	int numElems() const {
+		std::size_t quitar = _quitar.load(std::memory_order_acquire);
+		std::size_t poner = _poner.load(std::memory_order_acquire);
+		return (poner > quitar) ? (int) (poner - quitar) : 0;
+	}
+
+	/** @return Nmero mximo de elementos. */
+	int capacidad() const {
+		return (int) _tam;
+	}
+
+	ColaMPMC(const ColaMPMC &) = delete;
+	ColaMPMC &operator=(const ColaMPMC &) = delete;
+
+private:
+
+	/** Posicin del vector: nmero de secuencia y espacio
+	    para un elemento. */
+	struct Celda {
+		std::atomic<std::size_t> _sec;
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type _dato;
+
+		T &elem() {
+			return *reinterpret_cast<T *>(&_dato);
+		}
+	};
+
+	Celda *_v;               ///< Vector circular.
+	std::size_t _tam;        ///< Tamao de _v (potencia de dos).
+	std::size_t _mascara;    ///< _tam - 1.
+	char _relleno0[64];
+
+	std::atomic<std::size_t> _poner;  ///< Siguiente posicin para poner.
+	char _relleno1[64];
+
+	std::atomic<std::size_t> _quitar; ///< Siguiente posicin para quitar.
+	char _relleno2[64];
+};
+
+#endif // __COLA_CONCURRENTE_H
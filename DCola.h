@@ -15,7 +15,11 @@
 #define __DCOLA_H
 
 #include "Excepciones.h"
+#include "PoolNodos.h"
 #include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <utility>
 /**
  Implementacin del TAD Doble Cola utilizando una lista doblemente
  enlazada circular y con nodo fantasma.
@@ -26,6 +30,8 @@
    constructor sin parmetros.
  - PonDetras: DCola, Elem -> DCola. Generadora
  - ponDelante: DCola, Elem -> DCola. Modificadora.
+   (emplazaDetras y emplazaDelante construyen el elemento
+   directamente en la doble cola)
  - quitaPrim: DCola - -> DCola. Modificadora parcial
  - primero: DCola - -> Elem. Observadora parcial
  - quitaUlt: DCola - -> DCola. Modificadora parcial
@@ -36,11 +42,36 @@
  */
 template <class T>
 class DCola {
+private:
+	class Nodo;
+
 public:
 
+	/**
+	 Almacn del que pueden sacar sus nodos varias dobles colas
+	 (ver PoolNodos.h). Los nodos que se liberan en una de
+	 ellas se reutilizan en cualquiera, y toda la memoria se
+	 devuelve de golpe al destruir el almacn, que debe
+	 vivir ms que las dobles colas que lo usan. No se puede usar
+	 desde varios hilos a la vez.
+	 */
+	typedef PoolNodos<Nodo> Almacen;
+
 	/** Constructor; operacin DColaVacia. */
-	DCola() {
-		_fantasma = new Nodo();
+	DCola() : _almacen(NULL) {
+		_fantasma = creaNodo();
+		_fantasma->_sig = _fantasma;
+		_fantasma->_ant = _fantasma;
+		_numElems = 0;
+	}
+
+	/**
+	 Constructor; operacin DColaVacia. Los nodos de la doble
+	 cola (incluido el fantasma) saldrn del almacn dado en
+	 lugar de pedirse uno a uno con new.
+	 */
+	explicit DCola(Almacen &almacen) : _almacen(&almacen) {
+		_fantasma = creaNodo();
 		_fantasma->_sig = _fantasma;
 		_fantasma->_ant = _fantasma;
 		_numElems = 0;
@@ -56,7 +87,22 @@ public:
 	 Es una operacin generadora.
 	*/
 	void ponDetras(const T &e) {
-		insertaElem(e, _fantasma->_ant, _fantasma);
+		insertaElem(_fantasma->_ant, _fantasma, e);
+		_numElems++;
+	}
+
+	/** Igual que el anterior, pero mueve el elemento a la
+	    doble cola en lugar de copiarlo. */
+	void ponDetras(T &&e) {
+		insertaElem(_fantasma->_ant, _fantasma, std::move(e));
+		_numElems++;
+	}
+
+	/** Aade por detrs un elemento construido directamente
+	    en su nodo a partir de "args". */
+	template <class... Args>
+	void emplazaDetras(Args&&... args) {
+		insertaElem(_fantasma->_ant, _fantasma, std::forward<Args>(args)...);
 		_numElems++;
 	}
 
@@ -104,7 +150,22 @@ public:
 	 @param e Elemento que se aade
 	 */
 	void ponDelante(const T &e) {
-		insertaElem(e, _fantasma, _fantasma->_sig);
+		insertaElem(_fantasma, _fantasma->_sig, e);
+		++_numElems;
+	}
+
+	/** Igual que el anterior, pero mueve el elemento a la
+	    doble cola en lugar de copiarlo. */
+	void ponDelante(T &&e) {
+		insertaElem(_fantasma, _fantasma->_sig, std::move(e));
+		++_numElems;
+	}
+
+	/** Aade por delante un elemento construido directamente
+	    en su nodo a partir de "args". */
+	template <class... Args>
+	void emplazaDelante(Args&&... args) {
+		insertaElem(_fantasma, _fantasma->_sig, std::forward<Args>(args)...);
 		++_numElems;
 	}
 
@@ -164,16 +225,105 @@ public:
 		return _numElems;
 	}
 
+	/**
+	 Iterador bidireccional de la STL que recorre la doble
+	 cola sin modificarla, por ejemplo en un for de rango.
+	 El final del recorrido es el nodo fantasma, as que
+	 --end() es el ltimo elemento. Slo comprueba con
+	 assert que no se salga de la doble cola.
+	 */
+	class Iterador {
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const T *pointer;
+		typedef const T &reference;
+
+		Iterador() : _act(NULL), _fantasma(NULL) {}
+
+		const T &operator*() const {
+			assert(_act != _fantasma);
+			return _act->_elem;
+		}
+
+		const T *operator->() const {
+			return &operator*();
+		}
+
+		Iterador &operator++() {
+			assert(_act != _fantasma);
+			_act = _act->_sig;
+			return *this;
+		}
+
+		Iterador operator++(int) {
+			Iterador ret(*this);
+			operator++();
+			return ret;
+		}
+
+		Iterador &operator--() {
+			assert(_act->_ant != _fantasma);
+			_act = _act->_ant;
+			return *this;
+		}
+
+		Iterador operator--(int) {
+			Iterador ret(*this);
+			operator--();
+			return ret;
+		}
+
+		bool operator==(const Iterador &other) const {
+			return _act == other._act;
+		}
+
+		bool operator!=(const Iterador &other) const {
+			return !(this->operator==(other));
+		}
+	private:
+		friend class DCola;
+
+		Iterador(Nodo *act, Nodo *fantasma) :
+			_act(act), _fantasma(fantasma) {}
+
+		// Nodo actual del recorrido y fantasma de la doble cola
+		Nodo *_act;
+		Nodo *_fantasma;
+	};
+
+	/** @return iterador al primer elemento de la doble cola. */
+	Iterador begin() const {
+		return Iterador(_fantasma->_sig, _fantasma);
+	}
+
+	/** @return iterador al final del recorrido (el fantasma). */
+	Iterador end() const {
+		return Iterador(_fantasma, _fantasma);
+	}
+
 	// //
 	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
 	// A LA CLASE
 	// //
 
 	/** Constructor copia */
-	DCola(const DCola<T> &other) : _fantasma(NULL) {
+	DCola(const DCola<T> &other) : _fantasma(NULL), _almacen(NULL) {
 		copia(other);
 	}
 
+	/** Constructor de movimiento: se queda con los nodos de
+	    other (y con su almacn), y other queda vaca. Slo
+	    se crea un nodo fantasma nuevo. */
+	DCola(DCola<T> &&other) : _almacen(other._almacen) {
+		_fantasma = creaNodo();
+		_fantasma->_sig = _fantasma;
+		_fantasma->_ant = _fantasma;
+		_numElems = 0;
+		trasladaDe(other);
+	}
+
 	/** Operador de asignacin */
 	DCola<T> &operator=(const DCola<T> &other) {
 		if (this != &other) {
@@ -183,6 +333,17 @@ public:
 		return *this;
 	}
 
+	/** Asignacin de movimiento. La doble cola conserva su
+	    almacn. */
+	DCola<T> &operator=(DCola<T> &&other) {
+		if (this != &other) {
+			while (!esVacia())
+				quitaPrim();
+			trasladaDe(other);
+		}
+		return *this;
+	}
+
 	/** Operador de comparacin. */
 	bool operator==(const DCola<T> &rhs) const {
 		if (_numElems != rhs._numElems)
@@ -215,10 +376,39 @@ protected:
 		_fantasma = NULL;
 	}
 
+	/**
+	 Pasa a esta doble cola, que debe estar vaca, los
+	 elementos de other, que queda vaca. Si las dos usan el
+	 mismo almacn se enganchan los nodos tal cual entre
+	 nuestro fantasma y s mismo; si no, los elementos se
+	 mueven a nodos nuevos.
+	 */
+	void trasladaDe(DCola<T> &other) {
+		if (other.esVacia())
+			return;
+		if (_almacen == other._almacen) {
+			Nodo *prim = other._fantasma->_sig;
+			Nodo *ult = other._fantasma->_ant;
+			prim->_ant = _fantasma;
+			ult->_sig = _fantasma;
+			_fantasma->_sig = prim;
+			_fantasma->_ant = ult;
+			_numElems = other._numElems;
+			other._fantasma->_sig = other._fantasma;
+			other._fantasma->_ant = other._fantasma;
+			other._numElems = 0;
+		} else {
+			while (!other.esVacia()) {
+				ponDetras(std::move(other._fantasma->_sig->_elem));
+				other.quitaPrim();
+			}
+		}
+	}
+
 	void copia(const DCola<T> &other) {
 		// En vez de trabajar con punteros en la insercin,
 		// usamos ponDetras.
-		_fantasma = new Nodo();
+		_fantasma = creaNodo();
 		_fantasma->_sig = _fantasma;
 		_fantasma->_ant = _fantasma;
 		_numElems = 0;
@@ -242,8 +432,11 @@ private:
 	public:
 		Nodo() : _sig(NULL) {}
 		Nodo(const T &elem) : _elem(elem), _sig(NULL), _ant(NULL) {}
-		Nodo(Nodo *ant, const T &elem, Nodo *sig) : 
-		    _elem(elem), _sig(sig), _ant(ant) {}
+		// Construye el elemento a partir de "args" directamente
+		// dentro del nodo.
+		template <class... Args>
+		Nodo(Nodo *ant, Nodo *sig, Args&&... args) :
+		    _elem(std::forward<Args>(args)...), _sig(sig), _ant(ant) {}
 
 		T _elem;
 		Nodo *_sig;
@@ -259,8 +452,9 @@ private:
 	 Casos especiales: alguno de los nodos no existe
 	    nodo1 == NULL y/o nodo2 == NULL
 	*/
-	static Nodo *insertaElem(const T &e, Nodo *nodo1, Nodo *nodo2) {
-		Nodo *nuevo = new Nodo(nodo1, e, nodo2);
+	template <class... Args>
+	Nodo *insertaElem(Nodo *nodo1, Nodo *nodo2, Args&&... args) {
+		Nodo *nuevo = creaNodo(nodo1, nodo2, std::forward<Args>(args)...);
 		if (nodo1 != NULL)
 			nodo1->_sig = nuevo;
 		if (nodo2 != NULL)
@@ -275,7 +469,7 @@ private:
 	 Casos especiales: algunos de los nodos (anterior o siguiente
 	 a n) no existen.
 	*/
-	static void borraElem(Nodo *n) {
+	void borraElem(Nodo *n) {
 		if (n == NULL)
 			return;
 
@@ -285,7 +479,7 @@ private:
 			ant->_sig = sig;
 		if (sig != NULL)
 			sig->_ant = ant;
-		delete n;
+		destruyeNodo(n);
 	}
 
 	/**
@@ -295,8 +489,12 @@ private:
 	 liberar). En caso de pasarse un nodo vlido,
 	 su puntero al nodo anterior debe ser NULL (si no,
 	 no sera el primero de la lista!).
+	 Tambin con almacn se recorren los nodos uno a uno:
+	 cada hueco tiene que volver a la lista de libres para
+	 que lo reutilicen las dems dobles colas, y slo al destruir
+	 el almacn se devuelve la memoria de golpe.
 	 */
-	static void libera(Nodo *prim) {
+	void libera(Nodo *prim) {
 		if (prim == NULL)
 			return;
 
@@ -305,15 +503,37 @@ private:
 		while (prim != NULL) {
 			Nodo *aux = prim;
 			prim = prim->_sig;
-			delete aux;
+			destruyeNodo(aux);
 		}
 	}
 
+	/**
+	 Crea un nodo con los argumentos dados, en el almacn de
+	 la doble cola si tiene uno.
+	 */
+	template <class... Args>
+	Nodo *creaNodo(Args&&... args) {
+		if (_almacen != NULL)
+			return _almacen->crea(std::forward<Args>(args)...);
+		return new Nodo(std::forward<Args>(args)...);
+	}
+
+	/** Destruye un nodo creado con creaNodo. */
+	void destruyeNodo(Nodo *n) {
+		if (_almacen != NULL)
+			_almacen->destruye(n);
+		else
+			delete n;
+	}
+
 	// Puntero al nodo fantasma
 	Nodo *_fantasma;
 
 	// Nmero de elementos
 	unsigned int _numElems;
+
+	// Almacn del que salen los nodos (NULL si se usa new)
+	Almacen *_almacen;
 };
 
 #endif // __DCOLA_H
@@ -86,5 +86,17 @@ DECLARA_EXCEPCION(EArbolVacio);
  */
 DECLARA_EXCEPCION(EClaveErronea);
 
+/**
+ Excepcin generada por los grafos al usar un vrtice
+ que no existe.
+ */
+DECLARA_EXCEPCION(VerticeInexistente);
+
+/**
+ Excepcin generada por los grafos (y por otros TADs,
+ como Tabla) cuando alguno de los parmetros no es vlido.
+ */
+DECLARA_EXCEPCION(IllegalArgumentException);
+
 
 #endif // __EXCEPCIONES_H
@@ -0,0 +1,115 @@
+/*
+ * FicheroMapeado.h
+ *
+ * Acceso de slo lectura al contenido completo de un fichero,
+ * proyectndolo en memoria (mmap) cuando el sistema lo permite.
+ */
+
+#ifndef FICHEROMAPEADO_H_
+#define FICHEROMAPEADO_H_
+
+#include "Excepciones.h"
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define FICHERO_MAPEADO_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Contenido de un fichero visto como un array de bytes de slo lectura.
+ * En sistemas POSIX el fichero se proyecta en memoria con mmap, as que
+ * no se copia nada: el sistema lee las pginas a medida que se usan y
+ * varios procesos que abren el mismo fichero comparten la memoria. En
+ * otros sistemas se lee entero a un array.
+ *
+ * Los datos son vlidos mientras viva el objeto, que no se puede copiar.
+ */
+class FicheroMapeado {
+public:
+
+	/**
+	 * Abre el fichero y proyecta su contenido.
+	 * @throws IllegalArgumentException si no se puede abrir o leer.
+	 */
+	explicit FicheroMapeado(const std::string &nombre) :
+			_datos(NULL), _tam(0), _mapeado(false) {
+#ifdef FICHERO_MAPEADO_MMAP
+		int fd = ::open(nombre.c_str(), O_RDONLY);
+		if (fd < 0)
+			throw IllegalArgumentException("No se puede abrir " + nombre);
+		struct stat st;
+		if (::fstat(fd, &st) < 0) {
+			::close(fd);
+			throw IllegalArgumentException("No se puede leer " + nombre);
+		}
+		_tam = (std::size_t) st.st_size;
+		if (_tam > 0) {
+			void *p = ::mmap(NULL, _tam, PROT_READ, MAP_SHARED, fd, 0);
+			if (p == MAP_FAILED) {
+				::close(fd);
+				throw IllegalArgumentException("No se puede proyectar " + nombre);
+			}
+			_datos = static_cast<const char *>(p);
+			_mapeado = true;
+		}
+		// La proyeccin sigue siendo vlida despus de cerrar el fichero.
+		::close(fd);
+#else
+		std::ifstream ent(nombre.c_str(), std::ios::binary);
+		if (!ent)
+			throw IllegalArgumentException("No se puede abrir " + nombre);
+		ent.seekg(0, std::ios::end);
+		_tam = (std::size_t) ent.tellg();
+		ent.seekg(0, std::ios::beg);
+		char *buf = new char[_tam > 0 ? _tam : 1];
+		if (!ent.read(buf, _tam)) {
+			delete[] buf;
+			throw IllegalArgumentException("No se puede leer " + nombre);
+		}
+		_datos = buf;
+#endif
+	}
+
+	~FicheroMapeado() {
+#ifdef FICHERO_MAPEADO_MMAP
+		if (_mapeado)
+			::munmap(const_cast<char *>(_datos), _tam);
+#else
+		delete[] _datos;
+#endif
+	}
+
+	/** Primer byte del fichero (NULL si est vaco). */
+	const char *datos() const { return _datos; }
+
+	/** Tamao del fichero en bytes. */
+	std::size_t tam() const { return _tam; }
+
+	/**
+	 * Avisa al sistema de que el fichero se va a recorrer de principio
+	 * a fin, para que lea por adelantado.
+	 */
+	void secuencial() const {
+#if defined(FICHERO_MAPEADO_MMAP) && defined(MADV_SEQUENTIAL)
+		if (_mapeado)
+			::madvise(const_cast<char *>(_datos), _tam, MADV_SEQUENTIAL);
+#endif
+	}
+
+	FicheroMapeado(const FicheroMapeado &) = delete;
+	FicheroMapeado &operator=(const FicheroMapeado &) = delete;
+
+private:
+	const char *_datos;   // contenido del fichero
+	std::size_t _tam;     // tamao en bytes
+	bool _mapeado;        // si _datos viene de mmap
+};
+
+#endif /* FICHEROMAPEADO_H_ */
@@ -14,23 +14,14 @@ using namespace std;
 
 #include "Lista.h"
 #include "Cola.h"
-
-class VerticeInexistente : public ExcepcionTAD {
-public:
-	VerticeInexistente() {};
-	VerticeInexistente(const std::string &msg) : ExcepcionTAD(msg) {}
-};
-
-class IllegalArgumentException : public ExcepcionTAD {
-public:
-	IllegalArgumentException() {};
-	IllegalArgumentException(const std::string &msg) : ExcepcionTAD(msg) {}
-};
-
+#include "BFSParalela.h"
+#include "PilaDFS.h"
+#include "GrafoCSR.h"
+#include "LectorGrafo.h"
 
 typedef unsigned int uint;
 typedef Lista<uint> Adys;
-typedef Lista<uint>::Iterador Iter;
+typedef Lista<uint>::IteradorConst Iter;
 
 class Grafo {
 
@@ -53,22 +44,22 @@ public:
 	}
 
 	/**
-	 * Crea un grafo a partir de un fichero de entrada.
+	 * Crea un grafo a partir de un fichero de entrada (ver LectorGrafo,
+	 * que comprueba de una vez todos los vrtices, as que las aristas
+	 * se aaden sin volver a comprobarlos).
+	 * @param numHilos hilos que leen el fichero (0 para uno por ncleo).
 	 */
-	Grafo(string file) {
-		ifstream ent(file.c_str());
-		ent >> _V;
-		_E = 0;
+	Grafo(string file, uint numHilos = 1) {
+		LectorGrafo ent(file, numHilos);
+		_V = ent.V();
+		_E = ent.E();
 		_adj = new Adys[_V];
-		uint e;
-		ent >> e;
-		uint v, w;
-		for (uint i = 0; i < e; i++) {
-			ent >> v;
-			ent >> w;
-			ponArista(v, w);
+		const uint *aristas = ent.aristas();
+		for (uint i = 0; i < _E; i++) {
+			uint v = aristas[2 * i], w = aristas[2 * i + 1];
+			_adj[v].Cons(w);
+			_adj[w].Cons(v);
 		}
-		ent.close();
 	}
 
 	~Grafo(){
@@ -114,6 +105,15 @@ public:
 	}
 
 
+	/**
+	 * Guarda el grafo en el formato binario de GrafoCSR, para abrirlo
+	 * despus con GrafoCSR::proyecta.
+	 * @throws IllegalArgumentException si no se puede escribir.
+	 */
+	void guarda(const string &file) const {
+		GrafoCSR::guarda(*this, file);
+	}
+
 	/**
 	 * Muestra el grafo en el stream de salida o
 	 */
@@ -158,20 +158,27 @@ private:
 	uint _count;      // number of vertices connected to s
 	uint s;           // source vertex
 
-	// depth first search from v
-	void dfs(const Grafo& G, uint v) {
+	// depth first search from s (iterative, see PilaDFS)
+	template <class TipoGrafo>
+	void dfs(const TipoGrafo& G, uint s) {
+		PilaDFS<TipoGrafo> pila;
 		_count++;
-		_marked[v] = true;
-		for (Iter it = G.adj(v).principio(); it != G.adj(v).final(); it.avanza()) {
-			uint w = it.elem();
-			if (!_marked[w]) {
-				dfs(G, w);
+		_marked[s] = true;
+		pila.apila(G, s);
+		uint w;
+		while (!pila.esVacia()) {
+			if (!pila.siguiente(w)) pila.desapila();
+			else if (!_marked[w]) {
+				_count++;
+				_marked[w] = true;
+				pila.apila(G, w);
 			}
 		}
 	}
 
 public:
-	DepthFirstSearch(const Grafo& G, uint s) {
+	template <class TipoGrafo>
+	DepthFirstSearch(const TipoGrafo& G, uint s) {
 		_count = 0;
 		_marked = new bool[G.V()];
 		for(uint i = 0; i < G.V(); i++) _marked[i] = false;
@@ -201,20 +208,26 @@ private:
 	uint* edgeTo;     // edgeTo[v] = last edge on s-v path
 	uint s;           // source vertex
 
-	// depth first search from v
-	void dfs(const Grafo& G, uint v) {
-		marked[v] = true;
-		for (Iter it = G.adj(v).principio(); it != G.adj(v).final(); it.avanza()) {
-			uint w = it.elem();
-			if (!marked[w]) {
-				edgeTo[w] = v;
-				dfs(G, w);
+	// depth first search from s (iterative, see PilaDFS)
+	template <class TipoGrafo>
+	void dfs(const TipoGrafo& G, uint s) {
+		PilaDFS<TipoGrafo> pila;
+		marked[s] = true;
+		pila.apila(G, s);
+		uint w;
+		while (!pila.esVacia()) {
+			if (!pila.siguiente(w)) pila.desapila();
+			else if (!marked[w]) {
+				edgeTo[w] = pila.cima();
+				marked[w] = true;
+				pila.apila(G, w);
 			}
 		}
 	}
 
 public:
-	DepthFirstPaths(const Grafo& G, uint s) : s(s) {
+	template <class TipoGrafo>
+	DepthFirstPaths(const TipoGrafo& G, uint s) : s(s) {
 		edgeTo = new uint[G.V()];
 		marked = new bool[G.V()];
 		for(uint i = 0; i < G.V(); i++) marked[i] = false;
@@ -251,17 +264,17 @@ private:
 	uint* distTo;     // distTo[v] = number of edges shortest s-v path
 	uint s;           // source vertex
 
-	void bfs(const Grafo& G, uint s) {
+	template <class TipoGrafo>
+	void bfs(const TipoGrafo& G, uint s) {
 		Cola<uint> q;
-		for(uint v = 0; v < G.V(); v++) distTo[v] = numeric_limits<uint>::infinity();
+		for(uint v = 0; v < G.V(); v++) distTo[v] = numeric_limits<uint>::max();
 		distTo[s] = 0;
 		marked[s] = true;
 		q.ponDetras(s);
 
 		while (!q.esVacia()) {
 			uint v = q.primero(); q.quitaPrim();
-			for (Iter it = G.adj(v).principio(); it != G.adj(v).final(); it.avanza()) {
-				uint w = it.elem();
+			for (uint w : G.adj(v)) {
 				if (!marked[w]) {
 					edgeTo[w] = v;
 					distTo[w] = distTo[v] + 1;
@@ -272,8 +285,24 @@ private:
 		}
 	}
 
+	// parallel BFS from s, allocating the arrays (an undirected graph is
+	// its own reverse)
+	template <class TipoGrafo>
+	void bfsParalela(const TipoGrafo& G, uint numHilos) {
+		edgeTo = new uint[G.V()];
+		marked = new bool[G.V()];
+		distTo = new uint[G.V()];
+		for(uint v = 0; v < G.V(); v++) {
+			marked[v] = false;
+			distTo[v] = numeric_limits<uint>::max();
+		}
+		BFSParalela<TipoGrafo, TipoGrafo> bfs(G, G, numHilos);
+		bfs.recorre(&s, 1, marked, edgeTo, distTo);
+	}
+
 public:
-	BreadthFirstPaths(const Grafo& G, uint s) : s(s) {
+	template <class TipoGrafo>
+	BreadthFirstPaths(const TipoGrafo& G, uint s) : s(s) {
 		edgeTo = new uint[G.V()];
 		marked = new bool[G.V()];
 		distTo = new uint[G.V()];
@@ -281,6 +310,14 @@ public:
 		bfs(G, s);
 	}
 
+	// parallel direction-optimizing BFS with numHilos threads (0 = one
+	// per core), see BFSParalela; distTo is the same as above, edgeTo
+	// may pick another shortest path
+	template <class TipoGrafo>
+	BreadthFirstPaths(const TipoGrafo& G, uint s, uint numHilos) : s(s) {
+		bfsParalela(G, numHilos);
+	}
+
 	~BreadthFirstPaths() {
 		delete[] marked; marked = NULL;
 		delete[] edgeTo; edgeTo = NULL;
@@ -302,6 +339,8 @@ public:
 		return path;
 	}
 
+	// length of shortest path from s to v;
+	// numeric_limits<uint>::max() if there is no such path
 	uint distance(uint v) const {
 		return distTo[v];
 	}
@@ -315,31 +354,41 @@ private:
 	uint* _size;     // size[id] = number of vertices in given component
 	uint _count;     // number of connected components
 
-	// depth first search
-	void dfs(const Grafo& G, uint v) {
+	// mark v as part of the current component
+	void visit(uint v) {
 		marked[v] = true;
 		_id[v] = _count;
 		_size[_count]++;
-		//       for (int w : G.adj(v)) {
-		for (Iter it = G.adj(v).principio(); it != G.adj(v).final(); it.avanza()) {
-			uint w = it.elem();
-			if (!marked[w]) {
-				dfs(G, w);
+	}
+
+	// depth first search from s (iterative, see PilaDFS)
+	template <class TipoGrafo>
+	void dfs(const TipoGrafo& G, uint s, PilaDFS<TipoGrafo>& pila) {
+		visit(s);
+		pila.apila(G, s);
+		uint w;
+		while (!pila.esVacia()) {
+			if (!pila.siguiente(w)) pila.desapila();
+			else if (!marked[w]) {
+				visit(w);
+				pila.apila(G, w);
 			}
 		}
 	}
 
 public:
-	CC(const Grafo& G) {
+	template <class TipoGrafo>
+	CC(const TipoGrafo& G) {
 		marked = new bool[G.V()];
 		for(uint i = 0; i < G.V(); i++) marked[i] = false;
 		_id = new uint[G.V()];
 		_size = new uint[G.V()];
 		for(uint i = 0; i < G.V(); i++) _size[i] = 0;
 		_count = 0;
+		PilaDFS<TipoGrafo> pila;
 		for(uint v = 0; v < G.V(); v++) {
 			if (!marked[v]) {
-				dfs(G, v);
+				dfs(G, v, pila);
 				_count++;
 			}
 		}
@@ -0,0 +1,448 @@
+/*
+ * GrafoCSR.h
+ *
+ * Grafo inmutable guardado en formato CSR ("compressed sparse row"):
+ * todas las listas de adyacencia seguidas en un nico vector.
+ */
+
+#ifndef GRAFOCSR_H_
+#define GRAFOCSR_H_
+
+#include "Excepciones.h"
+#include "FicheroMapeado.h"
+#include "LectorGrafo.h"
+
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <ostream>
+#include <stdint.h>
+#include <utility>
+
+typedef unsigned int uint;
+
+/**
+ * Grafo (dirigido o no) que no se puede modificar una vez construido,
+ * con las listas de adyacencia guardadas en formato CSR: un vector
+ * _vecinos con los adyacentes de todos los vrtices, primero los del 0,
+ * luego los del 1, etc., y un vector _inicio de V+1 posiciones tal que
+ * los adyacentes de v son _vecinos[_inicio[v] .. _inicio[v+1]-1].
+ *
+ * Frente a Grafo y GrafoDirigido, que usan una Lista por vrtice, no hay
+ * ningn nodo por arista: cada arista ocupa un entero (dos si el grafo no
+ * es dirigido) y recorrer los adyacentes de un vrtice es recorrer un
+ * trozo de vector.
+ *
+ * Tiene las mismas operaciones de consulta que Grafo y GrafoDirigido
+ * (V, E, adj, reverse y mostrar), as que los algoritmos de Grafo.h y
+ * GrafoDirigido.h funcionan tambin sobre l. adj(v) no devuelve una
+ * Lista, sino un objeto Vecinos que se recorre igual (con principio,
+ * final, avanza y elem, o con un for de rango).
+ *
+ * Con guarda se escribe en un fichero binario que contiene los dos
+ * vectores tal cual, precedidos de una cabecera:
+ *
+ *   - Cabecera (32 bytes): la marca "GRAFOCSR", la versin del formato y
+ *     el entero 0x01020304 (para detectar ficheros de otra arquitectura),
+ *     de 32 bits cada uno; V y E, de 32 bits; y el nmero de adyacentes
+ *     guardados, de 64 bits.
+ *   - _inicio: V+1 enteros de 64 bits.
+ *   - _vecinos: tantos enteros de 32 bits como adyacentes.
+ *
+ * proyecta abre ese fichero con mmap y el grafo usa directamente las
+ * pginas proyectadas, sin leer ni convertir nada: abrir un grafo es
+ * inmediato sea cual sea su tamao, y el sistema slo lee del disco las
+ * partes que recorren los algoritmos.
+ */
+class GrafoCSR {
+public:
+
+	/**
+	 * Adyacentes de un vrtice: un trozo del vector de vecinos.
+	 * Se puede recorrer con un Iterador (principio/final) o con un
+	 * for de rango, igual que una Lista<uint>.
+	 */
+	class Vecinos {
+	public:
+
+		/**
+		 * Iterador sobre los adyacentes. Es un iterador de avance de
+		 * la STL y tiene tambin avanza y elem, como el de Lista.
+		 */
+		class Iterador {
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef uint value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef const uint *pointer;
+			typedef const uint &reference;
+
+			Iterador() : _act(NULL) {}
+
+			void avanza() { ++_act; }
+			const uint &elem() const { return *_act; }
+
+			const uint &operator*() const { return *_act; }
+			Iterador &operator++() { ++_act; return *this; }
+			Iterador operator++(int) { Iterador ret(*this); ++_act; return ret; }
+
+			bool operator==(const Iterador &other) const { return _act == other._act; }
+			bool operator!=(const Iterador &other) const { return _act != other._act; }
+
+		private:
+			friend class Vecinos;
+			Iterador(const uint *act) : _act(act) {}
+
+			const uint *_act;
+		};
+
+		Iterador principio() const { return Iterador(_ini); }
+		Iterador final() const { return Iterador(_fin); }
+		Iterador begin() const { return principio(); }
+		Iterador end() const { return final(); }
+
+		/** Nmero de adyacentes. */
+		uint numElems() const { return (uint) (_fin - _ini); }
+
+		bool esVacia() const { return _ini == _fin; }
+
+	private:
+		friend class GrafoCSR;
+		Vecinos(const uint *ini, const uint *fin) : _ini(ini), _fin(fin) {}
+
+		const uint *_ini;
+		const uint *_fin;
+	};
+
+	/**
+	 * Crea una copia en formato CSR de un Grafo o GrafoDirigido (o de
+	 * cualquier grafo con V, E y adj). Los adyacentes de cada vrtice
+	 * quedan en el mismo orden que en G, as que los algoritmos dan los
+	 * mismos resultados sobre los dos grafos.
+	 */
+	template <class TipoGrafo>
+	explicit GrafoCSR(const TipoGrafo& G) : _V(G.V()), _E(G.E()), _fichero(NULL) {
+		_inicio = new uint64_t[_V + 1];
+		_inicio[0] = 0;
+		for (uint v = 0; v < _V; v++)
+			_inicio[v + 1] = _inicio[v] + G.adj(v).numElems();
+		_vecinos = new uint[_inicio[_V]];
+		uint64_t pos = 0;
+		for (uint v = 0; v < _V; v++)
+			for (uint w : G.adj(v))
+				_vecinos[pos++] = w;
+	}
+
+	/**
+	 * Crea un grafo de V vrtices a partir de una lista de aristas.
+	 * La arista i-sima va de aristas[2*i] a aristas[2*i+1]. Si el
+	 * grafo no es dirigido, cada arista se aade en los dos sentidos.
+	 * Los adyacentes de cada vrtice quedan en el orden en que aparecen
+	 * en la lista.
+	 *
+	 * @throws VerticeInexistente si algn vrtice no existe (el grafo
+	 * no llega a construirse).
+	 */
+	GrafoCSR(uint V, const uint *aristas, uint numAristas, bool dirigido = true) :
+			_V(V), _E(numAristas), _fichero(NULL) {
+		for (uint64_t i = 0; i < 2 * (uint64_t) numAristas; i++)
+			if (aristas[i] >= V) throw VerticeInexistente();
+		construye(aristas, dirigido);
+	}
+
+	/**
+	 * Crea un grafo a partir de un fichero con el formato de
+	 * Grafo(string) y GrafoDirigido(string), ledo con LectorGrafo.
+	 * @param numHilos hilos que leen el fichero (0 para uno por ncleo).
+	 */
+	GrafoCSR(const std::string &fichero, bool dirigido, uint numHilos = 1) :
+			_fichero(NULL) {
+		LectorGrafo ent(fichero, numHilos);
+		_V = ent.V();
+		_E = ent.E();
+		construye(ent.aristas(), dirigido);
+	}
+
+	~GrafoCSR() {
+		libera();
+	}
+
+	/**
+	 * Constructor de copia.
+	 */
+	GrafoCSR(const GrafoCSR& G) : _V(G._V), _E(G._E), _fichero(NULL) {
+		copia(G);
+	}
+
+	/**
+	 * Constructor de movimiento; G queda sin vrtices.
+	 */
+	GrafoCSR(GrafoCSR&& G) : _V(G._V), _E(G._E), _inicio(G._inicio),
+			_vecinos(G._vecinos), _fichero(G._fichero) {
+		G._V = G._E = 0;
+		G._inicio = new uint64_t[1];
+		G._inicio[0] = 0;
+		G._vecinos = NULL;
+		G._fichero = NULL;
+	}
+
+	GrafoCSR& operator=(const GrafoCSR& G) {
+		if (this != &G) {
+			GrafoCSR aux(G);
+			intercambia(aux);
+		}
+		return *this;
+	}
+
+	GrafoCSR& operator=(GrafoCSR&& G) {
+		intercambia(G);
+		return *this;
+	}
+
+	/**
+	 * Devuelve el nmero de vrtices del grafo.
+	 */
+	uint V() const { return _V; }
+
+	/**
+	 * Devuelve el nmero de aristas del grafo.
+	 */
+	uint E() const { return _E; }
+
+	/**
+	 * Devuelve los adyacentes de v.
+	 * @throws VerticeInexistente si v no existe
+	 */
+	Vecinos adj(uint v) const {
+		if (v >= _V) throw VerticeInexistente();
+		return Vecinos(_vecinos + _inicio[v], _vecinos + _inicio[v + 1]);
+	}
+
+	/**
+	 * Devuelve el nmero de adyacentes de v.
+	 */
+	uint grado(uint v) const {
+		if (v >= _V) throw VerticeInexistente();
+		return (uint) (_inicio[v + 1] - _inicio[v]);
+	}
+
+	/**
+	 * Devuelve el grafo con todas las aristas invertidas (el mismo
+	 * grafo, si no es dirigido). Como en GrafoDirigido::reverse, los
+	 * adyacentes de cada vrtice quedan de mayor a menor.
+	 */
+	GrafoCSR reverse() const {
+		GrafoCSR R(_V, _E);
+		for (uint v = 0; v <= _V; v++) R._inicio[v] = 0;
+		for (uint64_t i = 0; i < _inicio[_V]; i++)
+			R._inicio[_vecinos[i] + 1]++;
+		for (uint v = 0; v < _V; v++)
+			R._inicio[v + 1] += R._inicio[v];
+
+		R._vecinos = new uint[_inicio[_V]];
+		uint64_t *sig = new uint64_t[_V];
+		for (uint v = 0; v < _V; v++) sig[v] = R._inicio[v];
+		for (uint v = _V; v-- > 0; )
+			for (uint64_t i = _inicio[v]; i < _inicio[v + 1]; i++)
+				R._vecinos[sig[_vecinos[i]]++] = v;
+		delete[] sig;
+		return R;
+	}
+
+	/**
+	 * Guarda el grafo en un fichero binario que se puede abrir con
+	 * proyecta.
+	 * @throws IllegalArgumentException si no se puede escribir.
+	 */
+	void guarda(const std::string &fichero) const {
+		std::ofstream sal(fichero.c_str(), std::ios::binary);
+		escribeCabecera(sal, _V, _E, _inicio[_V]);
+		sal.write(reinterpret_cast<const char *>(_inicio),
+				(std::streamsize) ((_V + 1) * sizeof(uint64_t)));
+		sal.write(reinterpret_cast<const char *>(_vecinos),
+				(std::streamsize) (_inicio[_V] * sizeof(uint)));
+		if (!sal)
+			throw IllegalArgumentException("No se puede escribir " + fichero);
+	}
+
+	/**
+	 * Guarda un Grafo o GrafoDirigido (o cualquier grafo con V, E y adj)
+	 * en el formato binario de GrafoCSR, sin construir antes el GrafoCSR.
+	 * @throws IllegalArgumentException si no se puede escribir.
+	 */
+	template <class TipoGrafo>
+	static void guarda(const TipoGrafo& G, const std::string &fichero) {
+		std::ofstream sal(fichero.c_str(), std::ios::binary);
+		uint64_t pos = 0;
+		for (uint v = 0; v < G.V(); v++)
+			pos += G.adj(v).numElems();
+		escribeCabecera(sal, G.V(), G.E(), pos);
+		pos = 0;
+		sal.write(reinterpret_cast<const char *>(&pos), sizeof(pos));
+		for (uint v = 0; v < G.V(); v++) {
+			pos += G.adj(v).numElems();
+			sal.write(reinterpret_cast<const char *>(&pos), sizeof(pos));
+		}
+		for (uint v = 0; v < G.V(); v++)
+			for (uint w : G.adj(v))
+				sal.write(reinterpret_cast<const char *>(&w), sizeof(w));
+		if (!sal)
+			throw IllegalArgumentException("No se puede escribir " + fichero);
+	}
+
+	/**
+	 * Abre un grafo guardado con guarda, proyectando el fichero en
+	 * memoria. Slo se comprueban la cabecera y el tamao del fichero,
+	 * no los adyacentes, para no tener que leerlo entero. El fichero no
+	 * debe modificarse mientras el grafo est abierto.
+	 * @throws IllegalArgumentException si el fichero no se puede abrir
+	 *         o no tiene el formato correcto.
+	 */
+	static GrafoCSR proyecta(const std::string &fichero) {
+		FicheroMapeado *f = new FicheroMapeado(fichero);
+		const char *p = f->datos();
+		Cabecera c;
+		bool correcto = f->tam() >= sizeof(c);
+		if (correcto) {
+			memcpy(&c, p, sizeof(c));
+			correcto = memcmp(c._marca, marca(), sizeof(c._marca)) == 0 &&
+					c._version == VERSION && c._orden == ORDEN &&
+					f->tam() == sizeof(c) + (c._V + (uint64_t) 1) * sizeof(uint64_t) +
+							c._numVecinos * sizeof(uint);
+		}
+		const uint64_t *inicio = reinterpret_cast<const uint64_t *>(p + sizeof(c));
+		if (!correcto || inicio[c._V] != c._numVecinos) {
+			delete f;
+			throw IllegalArgumentException("Formato incorrecto en " + fichero);
+		}
+
+		GrafoCSR G(c._V, c._E, f);
+		G._inicio = const_cast<uint64_t *>(inicio);
+		G._vecinos = const_cast<uint *>(reinterpret_cast<const uint *>(
+				inicio + c._V + 1));
+		return G;
+	}
+
+	/**
+	 * Indica si el grafo usa directamente un fichero proyectado (ver
+	 * proyecta).
+	 */
+	bool proyectado() const { return _fichero != NULL; }
+
+	/**
+	 * Muestra el grafo en el stream de salida o
+	 */
+	void mostrar(std::ostream& o) const {
+		o << _V << " vertices, " << _E << " aristas" << std::endl;
+		for (uint v = 0; v < _V; v++) {
+			o << v << ": ";
+			for (uint64_t i = _inicio[v]; i < _inicio[v + 1]; i++)
+				o << _vecinos[i] << " ";
+			o << std::endl;
+		}
+	}
+
+private:
+
+	/** Cabecera del formato binario (ver guarda). */
+	struct Cabecera {
+		char _marca[8];
+		uint32_t _version;
+		uint32_t _orden;
+		uint32_t _V;
+		uint32_t _E;
+		uint64_t _numVecinos;
+	};
+
+	static const uint32_t VERSION = 1;
+	static const uint32_t ORDEN = 0x01020304;
+	static const char *marca() { return "GRAFOCSR"; }
+
+	static void escribeCabecera(std::ostream &sal, uint V, uint E,
+			uint64_t numVecinos) {
+		Cabecera c;
+		memcpy(c._marca, marca(), sizeof(c._marca));
+		c._version = VERSION;
+		c._orden = ORDEN;
+		c._V = V;
+		c._E = E;
+		c._numVecinos = numVecinos;
+		sal.write(reinterpret_cast<const char *>(&c), sizeof(c));
+	}
+
+	// Grafo de V vrtices con _inicio reservado (sin rellenar) y
+	// sin vector de vecinos; lo usa reverse.
+	GrafoCSR(uint V, uint E) : _V(V), _E(E),
+			_inicio(new uint64_t[V + 1]), _vecinos(NULL), _fichero(NULL) {}
+
+	// Grafo cuyos vectores estn en el fichero proyectado f; lo usa
+	// proyecta, que rellena _inicio y _vecinos.
+	GrafoCSR(uint V, uint E, FicheroMapeado *f) : _V(V), _E(E),
+			_inicio(NULL), _vecinos(NULL), _fichero(f) {}
+
+	void libera() {
+		if (_fichero != NULL)
+			delete _fichero;
+		else {
+			delete[] _inicio;
+			delete[] _vecinos;
+		}
+	}
+
+	// Construye las listas de adyacencia a partir de las _E aristas
+	// (con los vrtices ya comprobados), en dos pasadas.
+	void construye(const uint *aristas, bool dirigido) {
+		// Primera pasada: grado de cada vrtice.
+		_inicio = new uint64_t[_V + 1];
+		for (uint v = 0; v <= _V; v++) _inicio[v] = 0;
+		for (uint i = 0; i < _E; i++) {
+			_inicio[aristas[2 * i] + 1]++;
+			if (!dirigido) _inicio[aristas[2 * i + 1] + 1]++;
+		}
+		for (uint v = 0; v < _V; v++)
+			_inicio[v + 1] += _inicio[v];
+
+		// Segunda pasada: colocamos cada arista en su sitio.
+		_vecinos = new uint[_inicio[_V]];
+		uint64_t *sig = new uint64_t[_V];
+		for (uint v = 0; v < _V; v++) sig[v] = _inicio[v];
+		for (uint i = 0; i < _E; i++) {
+			uint v = aristas[2 * i], w = aristas[2 * i + 1];
+			_vecinos[sig[v]++] = w;
+			if (!dirigido) _vecinos[sig[w]++] = v;
+		}
+		delete[] sig;
+	}
+
+	void copia(const GrafoCSR& other) {
+		_inicio = new uint64_t[_V + 1];
+		for (uint v = 0; v <= _V; v++) _inicio[v] = other._inicio[v];
+		_vecinos = new uint[_inicio[_V]];
+		for (uint64_t i = 0; i < _inicio[_V]; i++) _vecinos[i] = other._vecinos[i];
+	}
+
+	void intercambia(GrafoCSR& other) {
+		std::swap(_V, other._V);
+		std::swap(_E, other._E);
+		std::swap(_inicio, other._inicio);
+		std::swap(_vecinos, other._vecinos);
+		std::swap(_fichero, other._fichero);
+	}
+
+	uint _V;             // numero de vertices
+	uint _E;             // numero de aristas
+	uint64_t* _inicio;   // _inicio[v] = posicion en _vecinos del primer adyacente de v
+	uint* _vecinos;      // adyacentes de todos los vertices, seguidos
+	FicheroMapeado* _fichero;  // fichero con _inicio y _vecinos (o NULL)
+};
+
+/**
+ * Para mostrar grafos por la salida estndar.
+ */
+inline std::ostream& operator<<(std::ostream& o, const GrafoCSR& g) {
+	g.mostrar(o);
+	return o;
+}
+
+#endif /* GRAFOCSR_H_ */
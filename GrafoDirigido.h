@@ -13,24 +13,15 @@
 
 #include "Lista.h"
 #include "Cola.h"
+#include "BFSParalela.h"
+#include "PilaDFS.h"
+#include "GrafoCSR.h"
+#include "LectorGrafo.h"
 //#include "Pila.h"
 
-class VerticeInexistente : public ExcepcionTAD {
-public:
-	VerticeInexistente() {};
-	VerticeInexistente(const std::string &msg) : ExcepcionTAD(msg) {}
-};
-
-class IllegalArgumentException : public ExcepcionTAD {
-public:
-	IllegalArgumentException() {};
-	IllegalArgumentException(const std::string &msg) : ExcepcionTAD(msg) {}
-};
-
-
 typedef unsigned int uint;
 typedef Lista<uint> Adys;
-typedef Lista<uint>::Iterador Iter;
+typedef Lista<uint>::IteradorConst Iter;
 typedef Lista<uint> Path;
 
 
@@ -55,22 +46,21 @@ public:
 	}
 
 	/**
-	 * Crea un grafo a partir de un fichero de entrada.
+	 * Crea un grafo a partir de un fichero de entrada (ver LectorGrafo,
+	 * que comprueba de una vez todos los vrtices, as que las aristas
+	 * se aaden sin volver a comprobarlos).
+	 * @param numHilos hilos que leen el fichero (0 para uno por ncleo).
 	 */
-	GrafoDirigido(string file) {
-		ifstream ent(file.c_str());
-		ent >> _V;
-		_E = 0;
+	GrafoDirigido(string file, uint numHilos = 1) {
+		LectorGrafo ent(file, numHilos);
+		_V = ent.V();
+		_E = ent.E();
 		_adj = new Adys[_V];
-		uint e;
-		ent >> e;
-		uint v, w;
-		for (uint i = 0; i < e; i++) {
-			ent >> v;
-			ent >> w;
-			ponArista(v, w);
+		const uint *aristas = ent.aristas();
+		for (uint i = 0; i < _E; i++) {
+			uint v = aristas[2 * i], w = aristas[2 * i + 1];
+			_adj[v].Cons(w);
 		}
-		ent.close();
 	}
 
 	~GrafoDirigido(){
@@ -127,6 +117,15 @@ public:
 		return R;
 	}
 
+	/**
+	 * Guarda el grafo en el formato binario de GrafoCSR, para abrirlo
+	 * despus con GrafoCSR::proyecta.
+	 * @throws IllegalArgumentException si no se puede escribir.
+	 */
+	void guarda(const string &file) const {
+		GrafoCSR::guarda(*this, file);
+	}
+
 	/**
 	 * Muestra el grafo en el stream de salida o
 	 */
@@ -169,20 +168,26 @@ private:
 	uint* edgeTo;     // edgeTo[v] = last edge on s-v path
 	uint s;           // source vertex
 
-	// depth first search from v
-	void dfs(const GrafoDirigido& G, uint v) {
-		marked[v] = true;
-		for (Iter it = G.adj(v).principio(); it != G.adj(v).final(); it.avanza()) {
-			uint w = it.elem();
-			if (!marked[w]) {
-				edgeTo[w] = v;
-				dfs(G, w);
+	// depth first search from s (iterative, see PilaDFS)
+	template <class TipoGrafo>
+	void dfs(const TipoGrafo& G, uint s) {
+		PilaDFS<TipoGrafo> pila;
+		marked[s] = true;
+		pila.apila(G, s);
+		uint w;
+		while (!pila.esVacia()) {
+			if (!pila.siguiente(w)) pila.desapila();
+			else if (!marked[w]) {
+				edgeTo[w] = pila.cima();
+				marked[w] = true;
+				pila.apila(G, w);
 			}
 		}
 	}
 
 public:
-	DepthFirstDirectedPaths(const GrafoDirigido& G, uint s) : s(s) {
+	template <class TipoGrafo>
+	DepthFirstDirectedPaths(const TipoGrafo& G, uint s) : s(s) {
 		edgeTo = new uint[G.V()];
 		marked = new bool[G.V()];
 		for(uint i = 0; i < G.V(); i++) marked[i] = false;
@@ -219,7 +224,8 @@ private:
 	//	uint s;           // source vertex
 
 	// BFS from single source
-	void bfs(const GrafoDirigido& G, uint s) {
+	template <class TipoGrafo>
+	void bfs(const TipoGrafo& G, uint s) {
 		Cola<uint> q;
 		distTo[s] = 0;
 		marked[s] = true;
@@ -227,8 +233,7 @@ private:
 
 		while (!q.esVacia()) {
 			uint v = q.primero(); q.quitaPrim();
-			for (Iter it = G.adj(v).principio(); it != G.adj(v).final(); it.avanza()) {
-				uint w = it.elem();
+			for (uint w : G.adj(v)) {
 				if (!marked[w]) {
 					edgeTo[w] = v;
 					distTo[w] = distTo[v] + 1;
@@ -240,7 +245,8 @@ private:
 	}
 
 	// BFS from multiple sources
-	void bfs(const GrafoDirigido& G, Lista<uint> sources) {
+	template <class TipoGrafo>
+	void bfs(const TipoGrafo& G, Lista<uint> sources) {
 		Cola<uint> q;
 		for(Iter it = sources.principio(); it != sources.final(); it.avanza()) {
 			uint s = it.elem();
@@ -251,8 +257,7 @@ private:
 
 		while (!q.esVacia()) {
 			uint v = q.primero(); q.quitaPrim();
-			for (Iter it = G.adj(v).principio(); it != G.adj(v).final(); it.avanza()) {
-				uint w = it.elem();
+			for (uint w : G.adj(v)) {
 				if (!marked[w]) {
 					edgeTo[w] = v;
 					distTo[w] = distTo[v] + 1;
@@ -263,34 +268,77 @@ private:
 		}
 	}
 
+	// parallel BFS from sources, allocating the arrays; the bottom-up steps
+	// need the predecessors, so it also takes the reverse digraph
+	template <class TipoGrafo, class TipoInverso>
+	void bfsParalela(const TipoGrafo& G, const TipoInverso& inv,
+			const uint *sources, uint numSources, uint numHilos) {
+		edgeTo = new uint[G.V()];
+		marked = new bool[G.V()];
+		distTo = new uint[G.V()];
+		for(uint v = 0; v < G.V(); v++) {
+			marked[v] = false;
+			distTo[v] = numeric_limits<uint>::max();
+		}
+		BFSParalela<TipoGrafo, TipoInverso> bfs(G, inv, numHilos);
+		bfs.recorre(sources, numSources, marked, edgeTo, distTo);
+	}
+
 public:
 	// single source
-	BreadthFirstDirectedPaths(const GrafoDirigido& G, uint s) {
+	template <class TipoGrafo>
+	BreadthFirstDirectedPaths(const TipoGrafo& G, uint s) {
 		edgeTo = new uint[G.V()];
 		marked = new bool[G.V()];
 		distTo = new uint[G.V()];
 		for(uint i = 0; i < G.V(); i++) marked[i] = false;
-		for(uint v = 0; v < G.V(); v++) distTo[v] = numeric_limits<uint>::infinity();
+		for(uint v = 0; v < G.V(); v++) distTo[v] = numeric_limits<uint>::max();
 		bfs(G, s);
 	}
 
 	// multiple source
-	BreadthFirstDirectedPaths(const GrafoDirigido& G, const Lista<uint>& sources) {
+	template <class TipoGrafo>
+	BreadthFirstDirectedPaths(const TipoGrafo& G, const Lista<uint>& sources) {
 		edgeTo = new uint[G.V()];
 		marked = new bool[G.V()];
 		distTo = new uint[G.V()];
 		for(uint i = 0; i < G.V(); i++) marked[i] = false;
-		for(uint v = 0; v < G.V(); v++) distTo[v] = numeric_limits<uint>::infinity();
+		for(uint v = 0; v < G.V(); v++) distTo[v] = numeric_limits<uint>::max();
 		bfs(G, sources);
 	}
 
+	// single source, parallel direction-optimizing BFS with numHilos
+	// threads (0 = one per core), see BFSParalela; distTo is the same as
+	// above, edgeTo may pick another shortest path
+	template <class TipoGrafo>
+	BreadthFirstDirectedPaths(const TipoGrafo& G, uint s, uint numHilos) {
+		bfsParalela(G, G.reverse(), &s, 1, numHilos);
+	}
+
+	// same, with the reverse digraph already built (to run many searches
+	// on the same digraph)
+	template <class TipoGrafo, class TipoInverso>
+	BreadthFirstDirectedPaths(const TipoGrafo& G, const TipoInverso& inv,
+			uint s, uint numHilos) {
+		bfsParalela(G, inv, &s, 1, numHilos);
+	}
+
+	// multiple source, parallel
+	template <class TipoGrafo>
+	BreadthFirstDirectedPaths(const TipoGrafo& G, const Lista<uint>& sources,
+			uint numHilos) {
+		vector<uint> s(sources.begin(), sources.end());
+		bfsParalela(G, G.reverse(), s.data(), (uint) s.size(), numHilos);
+	}
+
 	~BreadthFirstDirectedPaths() {
 		delete[] marked; marked = NULL;
 		delete[] edgeTo; edgeTo = NULL;
 		delete[] distTo; distTo = NULL;
 	}
 
-	// length of shortest path from s (or sources) to v
+	// length of shortest path from s (or sources) to v;
+	// numeric_limits<uint>::max() if there is no such path
 	uint distance(uint v) const {
 		return distTo[v];
 	}
@@ -325,31 +373,50 @@ private:
 	uint preCounter;        // counter or preorder numbering
 	uint postCounter;       // counter for postorder numbering
 
-	// run DFS in digraph G from vertex v and compute preorder/postorder
-	void dfs(const GrafoDirigido& G, uint v) {
+	// v is reached for the first time
+	void enter(uint v) {
 		marked[v] = true;
 		pre[v] = preCounter++;
 		preorder.ponDr(v);
-		for (Iter it = G.adj(v).principio(); it != G.adj(v).final(); it.avanza()) {
-			uint w = it.elem();
-			if (!marked[w]) {
-				dfs(G, w);
-			}
-		}
+	}
+
+	// all the vertices reachable from v are done
+	void leave(uint v) {
 		postorder.ponDr(v);
 		post[v] = postCounter++;
 		revPost.Cons(v);
 	}
 
+	// run DFS in digraph G from vertex s and compute preorder/postorder
+	// (iterative, see PilaDFS)
+	template <class TipoGrafo>
+	void dfs(const TipoGrafo& G, uint s, PilaDFS<TipoGrafo>& pila) {
+		enter(s);
+		pila.apila(G, s);
+		uint w;
+		while (!pila.esVacia()) {
+			if (!pila.siguiente(w)) {
+				leave(pila.cima());
+				pila.desapila();
+			}
+			else if (!marked[w]) {
+				enter(w);
+				pila.apila(G, w);
+			}
+		}
+	}
+
 public:
 	// depth-first search preorder and postorder in a digraph
-	DepthFirstOrder(const GrafoDirigido& G) {
+	template <class TipoGrafo>
+	DepthFirstOrder(const TipoGrafo& G) {
 		pre    = new int[G.V()]; preCounter = 0;
 		post   = new int[G.V()]; postCounter = 0;
 		marked    = new bool[G.V()];
 		for (uint v = 0; v < G.V(); v++) marked[v] = false;
+		PilaDFS<TipoGrafo> pila;
 		for (uint v = 0; v < G.V(); v++)
-			if (!marked[v]) dfs(G, v);
+			if (!marked[v]) dfs(G, v, pila);
 	}
 
 	int prenum(int v) const {
@@ -387,19 +454,27 @@ private:
 	bool hayciclo;
 
 	// check that algorithm computes either the topological order or finds a directed cycle
-	void dfs(const GrafoDirigido& G, int v) {
-		onStack[v] = true;
-		marked[v] = true;
-		for (Iter it = G.adj(v).principio(); it != G.adj(v).final(); it.avanza()) {
-			uint w = it.elem();
-			// short circuit if directed cycle found
-			if (hayciclo) return;
-			//found new vertex, so recur
+	// (iterative, see PilaDFS; onStack marks the vertices in pila)
+	template <class TipoGrafo>
+	void dfs(const TipoGrafo& G, uint s, PilaDFS<TipoGrafo>& pila) {
+		onStack[s] = true;
+		marked[s] = true;
+		pila.apila(G, s);
+		uint w;
+		while (!pila.esVacia()) {
+			uint v = pila.cima();
+			if (!pila.siguiente(w)) {
+				onStack[v] = false;
+				pila.desapila();
+			}
+			//found new vertex, so go down
 			else if (!marked[w]) {
 				edgeTo[w] = v;
-				dfs(G, w);
+				onStack[w] = true;
+				marked[w] = true;
+				pila.apila(G, w);
 			}
-			// trace back directed cycle
+			// trace back directed cycle and stop
 			else if (onStack[w]) {
 				hayciclo = true;
 				for (uint x = v; x != w; x = edgeTo[x]) {
@@ -407,21 +482,23 @@ private:
 				}
 				ciclo.Cons(w);
 				ciclo.Cons(v);
+				pila.vacia();
 			}
 		}
-		onStack[v] = false;
 	}
 
 public:
-	DirectedCycle(const GrafoDirigido& G) {
+	template <class TipoGrafo>
+	DirectedCycle(const TipoGrafo& G) {
 		hayciclo = false;
 		marked  = new bool[G.V()];
 		for (uint v = 0; v < G.V(); v++) marked[v] = false;
 		onStack = new bool[G.V()];
 		for (uint v = 0; v < G.V(); v++) onStack[v] = false;
 		edgeTo  = new int[G.V()];
-		for (uint v = 0; v < G.V(); v++)
-			if (!marked[v]) dfs(G, v);
+		PilaDFS<TipoGrafo> pila;
+		for (uint v = 0; v < G.V() && !hayciclo; v++)
+			if (!marked[v]) dfs(G, v, pila);
 	}
 
 	bool hasCycle() const { return hayciclo; }
@@ -435,7 +512,8 @@ private:
 	bool hayOrden;
 public:
 	// topological sort in a digraph
-	Topological(const GrafoDirigido& G) {
+	template <class TipoGrafo>
+	Topological(const TipoGrafo& G) {
 		DirectedCycle finder(G);
 		if (!finder.hasCycle()) {
 			hayOrden = true;
@@ -462,18 +540,26 @@ private:
 	int* _id;         // id[v] = id of strong component containing v
 	int _count;       // number of strongly-connected components
 
-	// DFS on graph G
-	void dfs(const GrafoDirigido& G, uint v) {
-		marked[v] = true;
-		_id[v] = _count;
-		for (Iter it = G.adj(v).principio(); it != G.adj(v).final(); it.avanza()) {
-			uint w = it.elem();
-			if (!marked[w]) dfs(G, w);
+	// DFS on graph G (iterative, see PilaDFS)
+	template <class TipoGrafo>
+	void dfs(const TipoGrafo& G, uint s, PilaDFS<TipoGrafo>& pila) {
+		marked[s] = true;
+		_id[s] = _count;
+		pila.apila(G, s);
+		uint w;
+		while (!pila.esVacia()) {
+			if (!pila.siguiente(w)) pila.desapila();
+			else if (!marked[w]) {
+				marked[w] = true;
+				_id[w] = _count;
+				pila.apila(G, w);
+			}
 		}
 	}
 
 public:
-	KosarajuSharirSCC(const GrafoDirigido& G) {
+	template <class TipoGrafo>
+	KosarajuSharirSCC(const TipoGrafo& G) {
 
 		// compute reverse postorder of reverse graph
 		DepthFirstOrder dfsrev(G.reverse());
@@ -484,10 +570,11 @@ public:
 		_id = new int[G.V()];
 		_count = 0;
 
+		PilaDFS<TipoGrafo> pila;
 		for (Iter it = dfsrev.reversePost().principio(); it != dfsrev.reversePost().final(); it.avanza()) {
 			uint v = it.elem();
 			if (!marked[v]) {
-				dfs(G, v);
+				dfs(G, v, pila);
 				_count++;
 			}
 		}
@@ -16,6 +16,249 @@
 #define __HASH_H
 
 #include <string>
+#include <cstring>
+#include <stdint.h>
+
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+#if defined(__SSE2__) && !defined(HASH_SIN_SIMD)
+#include <emmintrin.h>
+#define HASH_SSE2
+#endif
+
+
+// ----------------------------------------------------
+//
+// Funcin hash de 64 bits para secuencias de bytes
+//
+// ----------------------------------------------------
+
+
+/**
+ * Funciones auxiliares de hashCadena. No forman parte de la interfaz.
+ */
+namespace HashAux {
+
+	// Constantes impares de 64 bits con los bits bien repartidos.
+	const uint64_t P0 = 0xa0761d6478bd642fULL;
+	const uint64_t P1 = 0xe7037ed1a0b428dbULL;
+	const uint64_t P2 = 0x8ebc6af09c88c6e3ULL;
+	const uint64_t P3 = 0x589965cc75374cc3ULL;
+
+	// Primo de 32 bits usado al revolver los acumuladores.
+	const uint64_t P32 = 0x9e3779b1ULL;
+
+	// Cadenas de ms bytes que ste usan el recorrido por bandas.
+	const size_t LIMITE_BANDAS = 256;
+
+	// Tamao de cada banda (cuatro palabras de 64 bits).
+	const size_t TAM_BANDA = 32;
+
+	// Nmero de bandas entre dos revoltijos de los acumuladores.
+	const size_t BANDAS_POR_BLOQUE = 16;
+
+	/** Lee 8 bytes sin exigir alineamiento. */
+	inline uint64_t lee64(const unsigned char *p) {
+		uint64_t v;
+		memcpy(&v, p, sizeof(v));
+		return v;
+	}
+
+	/** Lee 4 bytes sin exigir alineamiento. */
+	inline uint64_t lee32(const unsigned char *p) {
+		uint32_t v;
+		memcpy(&v, p, sizeof(v));
+		return v;
+	}
+
+	/**
+	 * Multiplica a y b con resultado de 128 bits y deja en a la mitad
+	 * baja y en b la alta.
+	 */
+	inline void multiplica128(uint64_t &a, uint64_t &b) {
+#if defined(__SIZEOF_INT128__)
+		__uint128_t r = (__uint128_t) a * b;
+		a = (uint64_t) r;
+		b = (uint64_t) (r >> 64);
+#else
+		uint64_t ha = a >> 32, hb = b >> 32;
+		uint64_t la = (uint32_t) a, lb = (uint32_t) b;
+		uint64_t hh = ha * hb, hl = ha * lb, lh = la * hb, ll = la * lb;
+		uint64_t t = ll + (hl << 32);
+		uint64_t lo = t + (lh << 32);
+		uint64_t acarreo = (t < ll) + (lo < t);
+		a = lo;
+		b = hh + (hl >> 32) + (lh >> 32) + acarreo;
+#endif
+	}
+
+	/** Multiplica a y b y combina las dos mitades del resultado. */
+	inline uint64_t mezclaMul(uint64_t a, uint64_t b) {
+		multiplica128(a, b);
+		return a ^ b;
+	}
+
+	/**
+	 * Recorre las cadenas largas por bandas de 32 bytes con cuatro
+	 * acumuladores independientes. Cada palabra se combina con su clave,
+	 * se multiplican entre s sus dos mitades de 32 bits y el producto se
+	 * suma a su acumulador, junto con la palabra original en el acumulador
+	 * vecino para no perder informacin. Cada BANDAS_POR_BLOQUE bandas se
+	 * revuelven los acumuladores. La versin SSE2 procesa dos palabras por
+	 * instruccin y da exactamente el mismo resultado que la escalar.
+	 *
+	 * @param d datos (n > LIMITE_BANDAS).
+	 * @param n nmero de bytes.
+	 * @param s semilla ya mezclada.
+	 * @return valor que resume todas las bandas.
+	 */
+	inline uint64_t recorreBandas(const unsigned char *d, size_t n,
+			uint64_t s) {
+		const uint64_t k[4] = { s ^ P0, s ^ P1, s ^ P2, s ^ P3 };
+		uint64_t acc[4] = { P0, P1, P2, P3 };
+
+		// La ltima banda (que puede solaparse con la anterior) se trata
+		// aparte para no leer fuera de los datos.
+		size_t numBandas = (n - 1) / TAM_BANDA;
+
+#ifdef HASH_SSE2
+		__m128i k01 = _mm_loadu_si128((const __m128i *) k);
+		__m128i k23 = _mm_loadu_si128((const __m128i *) (k + 2));
+		__m128i a01 = _mm_loadu_si128((const __m128i *) acc);
+		__m128i a23 = _mm_loadu_si128((const __m128i *) (acc + 2));
+		const __m128i primo = _mm_set1_epi32((int) P32);
+
+		for (size_t i = 0; i <= numBandas; ++i) {
+			const unsigned char *p = (i < numBandas) ?
+				d + i * TAM_BANDA : d + n - TAM_BANDA;
+
+			__m128i d01 = _mm_loadu_si128((const __m128i *) p);
+			__m128i d23 = _mm_loadu_si128((const __m128i *) (p + 16));
+			__m128i x01 = _mm_xor_si128(d01, k01);
+			__m128i x23 = _mm_xor_si128(d23, k23);
+			__m128i m01 = _mm_mul_epu32(x01, _mm_srli_epi64(x01, 32));
+			__m128i m23 = _mm_mul_epu32(x23, _mm_srli_epi64(x23, 32));
+			// Palabras intercambiadas dentro de cada registro
+			d01 = _mm_shuffle_epi32(d01, _MM_SHUFFLE(1, 0, 3, 2));
+			d23 = _mm_shuffle_epi32(d23, _MM_SHUFFLE(1, 0, 3, 2));
+			a01 = _mm_add_epi64(a01, _mm_add_epi64(m01, d01));
+			a23 = _mm_add_epi64(a23, _mm_add_epi64(m23, d23));
+
+			if ((i + 1) % BANDAS_POR_BLOQUE == 0) {
+				a01 = _mm_xor_si128(a01, _mm_srli_epi64(a01, 47));
+				a23 = _mm_xor_si128(a23, _mm_srli_epi64(a23, 47));
+				a01 = _mm_xor_si128(a01, k01);
+				a23 = _mm_xor_si128(a23, k23);
+				// Producto de 64 x 32 bits a partir de dos de 32 x 32.
+				__m128i bajo01 = _mm_mul_epu32(a01, primo);
+				__m128i bajo23 = _mm_mul_epu32(a23, primo);
+				__m128i alto01 = _mm_mul_epu32(_mm_srli_epi64(a01, 32), primo);
+				__m128i alto23 = _mm_mul_epu32(_mm_srli_epi64(a23, 32), primo);
+				a01 = _mm_add_epi64(bajo01, _mm_slli_epi64(alto01, 32));
+				a23 = _mm_add_epi64(bajo23, _mm_slli_epi64(alto23, 32));
+			}
+		}
+
+		_mm_storeu_si128((__m128i *) acc, a01);
+		_mm_storeu_si128((__m128i *) (acc + 2), a23);
+#else
+		for (size_t i = 0; i <= numBandas; ++i) {
+			const unsigned char *p = (i < numBandas) ?
+				d + i * TAM_BANDA : d + n - TAM_BANDA;
+
+			uint64_t w[4];
+			for (int j = 0; j < 4; ++j)
+				w[j] = lee64(p + 8 * j);
+			for (int j = 0; j < 4; ++j) {
+				uint64_t x = w[j] ^ k[j];
+				acc[j] += (x & 0xffffffffULL) * (x >> 32) + w[j ^ 1];
+			}
+
+			if ((i + 1) % BANDAS_POR_BLOQUE == 0) {
+				for (int j = 0; j < 4; ++j) {
+					acc[j] ^= acc[j] >> 47;
+					acc[j] ^= k[j];
+					acc[j] *= P32;
+				}
+			}
+		}
+#endif
+
+		return mezclaMul(acc[0] ^ P1, acc[1] ^ s) ^
+			mezclaMul(acc[2] ^ P2, acc[3] ^ P3);
+	}
+
+} // namespace HashAux
+
+
+/**
+ * Calcula un hash de 64 bits de una secuencia de bytes. Se basa en
+ * productos de 64 x 64 bits (como wyhash), de modo que cada byte afecta a
+ * todos los bits del resultado y las cadenas cortas, las anagramas o las
+ * que slo se diferencian en un carcter dan valores sin relacin entre
+ * s. Las cadenas de ms de 256 bytes se recorren por bandas de 32 bytes
+ * con instrucciones SSE2 cuando estn disponibles (se pueden desactivar
+ * definiendo HASH_SIN_SIMD; el resultado es el mismo).
+ *
+ * @param datos puntero al primer byte.
+ * @param n nmero de bytes.
+ * @param semilla permite obtener funciones hash distintas e
+ *        independientes entre s.
+ * @return valor hash de 64 bits.
+ */
+inline uint64_t hashCadena(const void *datos, size_t n,
+		uint64_t semilla = 0) {
+	using namespace HashAux;
+
+	const unsigned char *d = (const unsigned char *) datos;
+	uint64_t s = semilla ^ mezclaMul(semilla ^ P0, P1);
+	uint64_t a, b;
+
+	if (n <= 16) {
+		if (n >= 4) {
+			// Dos lecturas de 4 bytes por cada extremo, que se solapan
+			// si hace falta para cubrir todos los bytes.
+			size_t desp = (n >> 3) << 2;
+			a = (lee32(d) << 32) | lee32(d + desp);
+			b = (lee32(d + n - 4) << 32) | lee32(d + n - 4 - desp);
+		} else if (n > 0) {
+			a = ((uint64_t) d[0] << 16) | ((uint64_t) d[n >> 1] << 8) | d[n - 1];
+			b = 0;
+		} else {
+			a = b = 0;
+		}
+	} else {
+		if (n <= LIMITE_BANDAS) {
+			// Bloques de 16 bytes encadenados; el ltimo puede solaparse
+			// con el anterior.
+			const unsigned char *p = d;
+			size_t resto = n;
+			while (resto > 16) {
+				s = mezclaMul(lee64(p) ^ P1, lee64(p + 8) ^ s);
+				p += 16;
+				resto -= 16;
+			}
+		} else {
+			s = recorreBandas(d, n, s);
+		}
+		a = lee64(d + n - 16);
+		b = lee64(d + n - 8);
+	}
+
+	a ^= P1;
+	b ^= s;
+	multiplica128(a, b);
+	return mezclaMul(a ^ P0 ^ n, b ^ P1);
+}
+
+/**
+ * Versin de hashCadena para cadenas de la STL.
+ */
+inline uint64_t hashCadena(const std::string &clave, uint64_t semilla = 0) {
+	return hashCadena(clave.data(), clave.size(), semilla);
+}
 
 // ----------------------------------------------------
 //
@@ -36,17 +279,75 @@ inline unsigned int hash(char clave) {
 	return clave;
 }
 
-// Nota: Esta funcin de hash para cadenas no es muy buena.
-inline unsigned int hash(std::string clave) {
-	
-	// Suma los valores ASCII de todos sus caracters.
-	unsigned int valor = 0;
-	for (unsigned int i=0; i<clave.length(); ++i) {
-		valor += clave[i];
-	}
-	return valor;
+// Las cadenas usan hashCadena y se quedan con 32 bits del resultado.
+// Todas las versiones dan el mismo valor para el mismo texto.
+inline unsigned int hash(const char *datos, size_t n) {
+	uint64_t h = hashCadena(datos, n);
+	return (unsigned int) (h ^ (h >> 32));
 }
 
+inline unsigned int hash(const std::string &clave) {
+	return ::hash(clave.data(), clave.size());
+}
+
+inline unsigned int hash(const char *clave) {
+	return ::hash(clave, strlen(clave));
+}
+
+// Sin esta versin, char* usara la funcin genrica en lugar de la anterior.
+inline unsigned int hash(char *clave) {
+	return ::hash((const char *) clave);
+}
+
+// Sin esta versin, los arrays de caracteres usaran la funcin genrica.
+template <size_t N>
+inline unsigned int hash(const char (&clave)[N]) {
+	return ::hash(clave, strlen(clave));
+}
+
+#if __cplusplus >= 201703L
+inline unsigned int hash(std::string_view clave) {
+	return ::hash(clave.data(), clave.size());
+}
+#endif
+
+
+// ----------------------------------------------------
+//
+// Claves compatibles
+//
+// ----------------------------------------------------
+
+
+/**
+ * Indica si en una tabla con claves de tipo C se puede buscar usando
+ * directamente una clave de tipo K, sin construir antes un objeto de tipo
+ * C. Para ello hash(K) debe dar el mismo valor que hash(C) para claves
+ * iguales y debe existir el operador C == K. Por defecto no se permite; se
+ * puede especializar para otros pares de tipos.
+ */
+template <class C, class K>
+struct ClaveCompatible {
+	static const bool valor = false;
+};
+
+template <>
+struct ClaveCompatible<std::string, const char *> {
+	static const bool valor = true;
+};
+
+template <>
+struct ClaveCompatible<std::string, char *> {
+	static const bool valor = true;
+};
+
+#if __cplusplus >= 201703L
+template <>
+struct ClaveCompatible<std::string, std::string_view> {
+	static const bool valor = true;
+};
+#endif
+
 
 /**
  * Funcin hash genrica para clases que implementen un
@@ -58,4 +359,29 @@ unsigned int hash(const C &clave) {
 }
 
 
+// ----------------------------------------------------
+//
+// Mezcla de valores hash
+//
+// ----------------------------------------------------
+
+
+/**
+ * Mezcla los bits de un valor hash (finalizador de MurmurHash3). Las
+ * funciones anteriores pueden devolver valores muy poco repartidos (la
+ * de los enteros es la identidad), y las tablas se quedan slo con los
+ * bits bajos al calcular la posicin con una mscara. Tras la mezcla,
+ * cada bit de entrada afecta a todos los de salida, de modo que claves
+ * consecutivas acaban en posiciones muy separadas.
+ */
+inline unsigned int mezcla(unsigned int h) {
+	h ^= h >> 16;
+	h *= 0x85ebca6bU;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35U;
+	h ^= h >> 16;
+	return h;
+}
+
+
 #endif // __HASH_H
@@ -0,0 +1,217 @@
+/*
+ * LectorGrafo.h
+ *
+ * Lectura rpida de los ficheros de texto con los que se construyen
+ * los grafos.
+ */
+
+#ifndef LECTORGRAFO_H_
+#define LECTORGRAFO_H_
+
+#include "Excepciones.h"
+#include "FicheroMapeado.h"
+
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef unsigned int uint;
+
+/**
+ * Lee un fichero de grafo en el formato de Grafo(string) y
+ * GrafoDirigido(string): el nmero de vrtices, el nmero de aristas y
+ * despus los dos extremos de cada arista, todo separado por blancos.
+ *
+ * En lugar de leer los enteros uno a uno con ifstream >>, el fichero se
+ * proyecta en memoria (FicheroMapeado) y se recorre con un analizador
+ * de enteros propio, sin locale ni formato. Opcionalmente el fichero se
+ * reparte en trozos que leen varios hilos: primero cada hilo cuenta los
+ * nmeros de su trozo, y con eso sabe en qu posicin del vector de
+ * aristas debe escribir los suyos, sin copias intermedias.
+ *
+ * Los vrtices no se comprueban arista a arista: cada hilo guarda el
+ * mayor nmero que ha ledo y al final se comprueba una sola vez.
+ */
+class LectorGrafo {
+public:
+
+	/**
+	 * Lee el fichero.
+	 * @param fichero nombre del fichero.
+	 * @param numHilos nmero de hilos que lo leen (0 para usar uno por
+	 *        ncleo).
+	 * @throws IllegalArgumentException si no se puede abrir, si contiene
+	 *         algo que no sea un nmero o faltan aristas.
+	 * @throws VerticeInexistente si alguna arista usa un vrtice que no
+	 *         existe.
+	 */
+	explicit LectorGrafo(const std::string &fichero, unsigned int numHilos = 1) :
+			_V(0), _E(0), _aristas(NULL) {
+		FicheroMapeado f(fichero);
+		f.secuencial();
+		const char *p = f.datos();
+		const char *fin = p + f.tam();
+
+		uint64_t V, E;
+		if (!leeNumero(p, fin, V) || !leeNumero(p, fin, E) ||
+				V > 0xFFFFFFFFu || E > 0xFFFFFFFFu)
+			throw IllegalArgumentException("Cabecera incorrecta en " + fichero);
+		_V = (uint) V;
+		_E = (uint) E;
+		_aristas = new uint[2 * (std::size_t) _E];
+
+		if (numHilos == 0)
+			numHilos = std::thread::hardware_concurrency();
+		if (numHilos == 0 || (std::size_t) (fin - p) < MIN_POR_HILO * numHilos)
+			numHilos = 1;
+
+		// Repartimos el resto del fichero en trozos que no partan
+		// ningn nmero.
+		std::vector<Trozo> trozos(numHilos);
+		for (unsigned int i = 0; i < numHilos; ++i) {
+			trozos[i]._ini = (i == 0) ? p : trozos[i - 1]._fin;
+			const char *corte = (i == numHilos - 1) ? fin :
+					p + (fin - p) / numHilos * (i + 1);
+			while (corte < fin && !esBlanco(*corte)) ++corte;
+			trozos[i]._fin = corte;
+		}
+
+		// Primera pasada: nmeros de cada trozo, y de ah dnde empieza
+		// a escribir cada uno.
+		ejecuta(trozos, &LectorGrafo::cuenta);
+		std::size_t total = 2 * (std::size_t) _E, pos = 0;
+		for (unsigned int i = 0; i < numHilos; ++i) {
+			trozos[i]._destino = _aristas + pos;
+			trozos[i]._max = (pos >= total) ? 0 :
+					(trozos[i]._num < total - pos) ? trozos[i]._num : total - pos;
+			pos += trozos[i]._num;
+		}
+		if (pos < total) {
+			delete[] _aristas;
+			throw IllegalArgumentException("Faltan aristas en " + fichero);
+		}
+
+		// Segunda pasada: leemos los nmeros. Los que sobran detrs de
+		// la ltima arista se ignoran, como haca la lectura con >>.
+		ejecuta(trozos, &LectorGrafo::lee);
+		uint mayor = 0;
+		for (unsigned int i = 0; i < numHilos; ++i) {
+			if (trozos[i]._error) {
+				delete[] _aristas;
+				throw IllegalArgumentException("Formato incorrecto en " + fichero);
+			}
+			if (trozos[i]._mayor > mayor) mayor = trozos[i]._mayor;
+		}
+		if (_E > 0 && mayor >= _V) {
+			delete[] _aristas;
+			throw VerticeInexistente();
+		}
+	}
+
+	~LectorGrafo() {
+		delete[] _aristas;
+	}
+
+	/** Nmero de vrtices. */
+	uint V() const { return _V; }
+
+	/** Nmero de aristas. */
+	uint E() const { return _E; }
+
+	/**
+	 * Extremos de las aristas: la arista i-sima va de aristas()[2*i] a
+	 * aristas()[2*i+1].
+	 */
+	const uint *aristas() const { return _aristas; }
+
+	LectorGrafo(const LectorGrafo &) = delete;
+	LectorGrafo &operator=(const LectorGrafo &) = delete;
+
+private:
+
+	/** Tamao mnimo (en bytes) que merece la pena darle a cada hilo. */
+	static const std::size_t MIN_POR_HILO = 1 << 20;
+
+	/** Trozo del fichero que lee un hilo. */
+	struct Trozo {
+		Trozo() : _ini(NULL), _fin(NULL), _num(0), _destino(NULL),
+				_max(0), _mayor(0), _error(false) {}
+
+		const char *_ini, *_fin;  // bytes del trozo
+		std::size_t _num;         // nmeros que contiene
+		uint *_destino;           // dnde se escriben
+		std::size_t _max;         // cuntos se escriben como mucho
+		uint _mayor;              // mayor nmero escrito
+		bool _error;              // si hay algo que no es un nmero
+	};
+
+	static bool esBlanco(char c) {
+		return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+	}
+
+	/**
+	 * Lee un entero sin signo saltando los blancos anteriores.
+	 * @return false si no queda ningn nmero o lo siguiente no lo es.
+	 */
+	static bool leeNumero(const char *&p, const char *fin, uint64_t &n) {
+		while (p < fin && esBlanco(*p)) ++p;
+		if (p == fin || (unsigned) (*p - '0') > 9)
+			return false;
+		n = 0;
+		// Cuando pasa de 32 bits dejamos de acumular (ser un error).
+		for (; p < fin && (unsigned) (*p - '0') <= 9; ++p)
+			if (n <= 0xFFFFFFFFu)
+				n = n * 10 + (*p - '0');
+		return true;
+	}
+
+	/** Cuenta los nmeros del trozo (los comienzos de palabra). */
+	static void cuenta(Trozo *t) {
+		std::size_t n = 0;
+		bool blanco = true;
+		for (const char *p = t->_ini; p < t->_fin; ++p) {
+			bool b = esBlanco(*p);
+			n += blanco && !b;
+			blanco = b;
+		}
+		t->_num = n;
+	}
+
+	/** Lee los nmeros del trozo y los escribe en su destino. */
+	static void lee(Trozo *t) {
+		const char *p = t->_ini;
+		uint mayor = 0;
+		uint64_t n;
+		for (std::size_t i = 0; i < t->_max; ++i) {
+			if (!leeNumero(p, t->_fin, n) || n > 0xFFFFFFFFu ||
+					(p < t->_fin && !esBlanco(*p))) {
+				t->_error = true;
+				return;
+			}
+			t->_destino[i] = (uint) n;
+			if ((uint) n > mayor) mayor = (uint) n;
+		}
+		t->_mayor = mayor;
+	}
+
+	/** Aplica op a todos los trozos, cada uno en un hilo. */
+	static void ejecuta(std::vector<Trozo> &trozos, void (*op)(Trozo *)) {
+		if (trozos.size() == 1) {
+			op(&trozos[0]);
+			return;
+		}
+		std::vector<std::thread> hilos;
+		for (std::size_t i = 0; i < trozos.size(); ++i)
+			hilos.push_back(std::thread(op, &trozos[i]));
+		for (std::size_t i = 0; i < hilos.size(); ++i)
+			hilos[i].join();
+	}
+
+	uint _V;          // numero de vertices
+	uint _E;          // numero de aristas
+	uint *_aristas;   // extremos de las aristas (2 * _E)
+};
+
+#endif /* LECTORGRAFO_H_ */
@@ -14,7 +14,11 @@
 #define __LISTA_H
 
 #include "Excepciones.h"
+#include "PoolNodos.h"
 #include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <utility>
 
 /**
  Implementacin del TAD Pila utilizando vectores dinmicos.
@@ -33,6 +37,13 @@
  - numElems: Lista -> Elem. Obervadora.
  - elem: Lista, Entero - -> Elem. Observador parcial.
 
+ Cons, ponDr e insertar tienen versiones que mueven el
+ elemento en lugar de copiarlo, y emplazaCons, emplazaDr
+ y emplaza lo construyen directamente en la lista.
+ - concatena: Lista, Lista -> Lista. Modificadora.
+ - empalma: Lista, Iterador, Lista[, Iterador, Iterador] -> Lista.
+   Modificadora.
+
  @author Marco Antonio Gmez Martn
  */
 template <class T>
@@ -48,8 +59,12 @@ private:
 	public:
 		Nodo() : _sig(NULL), _ant(NULL) {}
 		Nodo(const T &elem) : _elem(elem), _sig(NULL), _ant(NULL) {}
-		Nodo(Nodo *ant, const T &elem, Nodo *sig) : 
-		    _elem(elem), _sig(sig), _ant(ant) {}
+
+		// Construye el elemento a partir de "args" directamente
+		// dentro del nodo.
+		template <class... Args>
+		Nodo(Nodo *ant, Nodo *sig, Args&&... args) :
+		    _elem(std::forward<Args>(args)...), _sig(sig), _ant(ant) {}
 
 		T _elem;
 		Nodo *_sig;
@@ -58,8 +73,26 @@ private:
 
 public:
 
+	/**
+	 Almacn del que pueden sacar sus nodos varias listas
+	 (ver PoolNodos.h). Los nodos que se borran de una de
+	 ellas se reutilizan en cualquiera, y toda la memoria se
+	 devuelve de golpe al destruir el almacn, que debe
+	 vivir ms que las listas que lo usan. No se puede usar
+	 desde varios hilos a la vez.
+	 */
+	typedef PoolNodos<Nodo> Almacen;
+
 	/** Constructor; operacin ListaVacia. */
-	Lista() : _prim(NULL), _ult(NULL), _numElems(0) {}
+	Lista() : _prim(NULL), _ult(NULL), _numElems(0), _almacen(NULL) {}
+
+	/**
+	 Constructor; operacin ListaVacia. Los nodos de la lista
+	 saldrn del almacn dado en lugar de pedirse uno a uno
+	 con new.
+	 */
+	explicit Lista(Almacen &almacen) : _prim(NULL), _ult(NULL),
+			_numElems(0), _almacen(&almacen) {}
 
 	/** Destructor; elimina la lista doblemente enlazada. */
 	~Lista() {
@@ -74,10 +107,20 @@ public:
 	 la lista.
 	*/
 	void Cons(const T &elem) {
-		_numElems++;
-		_prim = insertaElem(elem, NULL, _prim);
-		if (_ult == NULL)
-			_ult = _prim;
+		insertaAntes(_prim, elem);
+	}
+
+	/** Igual que el anterior, pero mueve el elemento a la
+	    lista en lugar de copiarlo. */
+	void Cons(T &&elem) {
+		insertaAntes(_prim, std::move(elem));
+	}
+
+	/** Aade en la cabeza de la lista un elemento construido
+	    directamente en su nodo a partir de "args". */
+	template <class... Args>
+	void emplazaCons(Args&&... args) {
+		insertaAntes(_prim, std::forward<Args>(args)...);
 	}
 
 	/**
@@ -88,10 +131,20 @@ public:
 	 ponDr(e, Cons(x, xs)) = Cons(x, ponDr(e, xs))
 	*/
 	void ponDr(const T &elem) {
-		_numElems++;
-		_ult = insertaElem(elem, _ult, NULL);
-		if (_prim == NULL)
-			_prim = _ult;
+		insertaAntes(NULL, elem);
+	}
+
+	/** Igual que el anterior, pero mueve el elemento a la
+	    lista en lugar de copiarlo. */
+	void ponDr(T &&elem) {
+		insertaAntes(NULL, std::move(elem));
+	}
+
+	/** Aade al final de la lista un elemento construido
+	    directamente en su nodo a partir de "args". */
+	template <class... Args>
+	void emplazaDr(Args&&... args) {
+		insertaAntes(NULL, std::forward<Args>(args)...);
 	}
 
 	/**
@@ -205,25 +258,75 @@ public:
 	 elem(0, Cons(x, xs)) = x
 	 elem(n, Cons(x, xs)) = elem(n-1, xs) si n > 0
 	 error elem(n, xs) si !( 0 <= n < numElems(xs) )
+
+	 El recorrido empieza en el extremo de la lista ms
+	 cercano a idx. Para pedir muchas posiciones seguidas
+	 (elem(0), elem(1), ...) conviene usar un Cursor.
 	*/
 	const T &elem(unsigned int idx) const {
-		if (idx >= _numElems)
-			throw EAccesoInvalido();
+		return buscaNodo(idx, NULL, 0)->_elem;
+	}
 
-		Nodo *aux = _prim;
-		for (int i = 0; i < idx; ++i)
-			aux = aux->_sig;
+	/**
+	 Acceso por posicin que recuerda el ltimo nodo
+	 visitado, para los recorridos que piden elem(0),
+	 elem(1), ... (o en orden inverso): cada bsqueda
+	 empieza en el ms cercano de _prim, _ult y ese nodo,
+	 as que el recorrido cuesta O(1) por elemento en lugar
+	 de O(n). La lista no se modifica, de modo que varios
+	 hilos pueden leer la misma lista const, cada uno con su
+	 cursor. Como los iteradores, deja de ser vlido si se
+	 borran elementos o se inserta antes del ltimo visitado.
+	 */
+	class Cursor {
+	public:
+		explicit Cursor(const Lista &lista) : _lista(&lista),
+				_act(NULL), _idx(0) {}
 
-		return aux->_elem;
-	}
+		/** Igual que Lista::elem. */
+		const T &elem(unsigned int idx) {
+			_act = _lista->buscaNodo(idx, _act, _idx);
+			_idx = idx;
+			return _act->_elem;
+		}
+
+	private:
+		const Lista *_lista;
+
+		// ltimo nodo visitado (NULL al principio) y su posicin
+		const Nodo *_act;
+		unsigned int _idx;
+	};
 
 	/**
 	 Clase interna que implementa un iterador sobre
 	 la lista que permite recorrer la lista e incluso
 	 alterar el valor de sus elementos.
+
+	 Adems de avanza/elem/pon es un iterador de avance
+	 (forward iterator) de la STL, con operator++ y
+	 operator*, as que se puede usar con los algoritmos
+	 de <algorithm> y, a travs de begin/end, en los bucles
+	 for de rango. Estos operadores slo comprueban que el
+	 iterador sea vlido con assert (en la compilacin de
+	 depuracin), en lugar de lanzar una excepcin.
+
+	 Slo se obtiene de una lista no constante; las listas
+	 constantes devuelven un IteradorConst.
 	 */
+	class IteradorConst;
+
 	class Iterador {
 	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef T *pointer;
+		typedef T &reference;
+
+		/** Iterador fuera de la lista (como final()). */
+		Iterador() : _act(NULL) {}
+
 		void avanza() {
 			if (_act == NULL) throw EAccesoInvalido();
 			_act = _act->_sig;
@@ -246,17 +349,104 @@ public:
 		bool operator!=(const Iterador &other) const {
 			return !(this->operator==(other));
 		}
+
+		T &operator*() const {
+			assert(_act != NULL);
+			return _act->_elem;
+		}
+
+		T *operator->() const {
+			return &operator*();
+		}
+
+		Iterador &operator++() {
+			assert(_act != NULL);
+			_act = _act->_sig;
+			return *this;
+		}
+
+		Iterador operator++(int) {
+			Iterador ret(*this);
+			operator++();
+			return ret;
+		}
 	protected:
 		// Para que pueda construir objetos del
 		// tipo iterador
 		friend class Lista;
+		friend class IteradorConst;
 
-		Iterador() : _act(NULL) {}
 		Iterador(Nodo *act) : _act(act) {}
 
 		// Puntero al nodo actual del recorrido
 		Nodo *_act;
 	};
+
+	/**
+	 Iterador que recorre la lista sin poder alterarla: igual
+	 que Iterador, pero sin pon y con *it constante. Es el que
+	 devuelven principio(), final(), begin() y end() de una
+	 lista constante, y se puede obtener de cualquier Iterador.
+	 */
+	class IteradorConst {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const T *pointer;
+		typedef const T &reference;
+
+		/** Iterador fuera de la lista (como final()). */
+		IteradorConst() : _act(NULL) {}
+
+		IteradorConst(const Iterador &it) : _act(it._act) {}
+
+		void avanza() {
+			if (_act == NULL) throw EAccesoInvalido();
+			_act = _act->_sig;
+		}
+
+		const T &elem() const {
+			if (_act == NULL) throw EAccesoInvalido();
+			return _act->_elem;
+		}
+
+		bool operator==(const IteradorConst &other) const {
+			return _act == other._act;
+		}
+
+		bool operator!=(const IteradorConst &other) const {
+			return !(this->operator==(other));
+		}
+
+		const T &operator*() const {
+			assert(_act != NULL);
+			return _act->_elem;
+		}
+
+		const T *operator->() const {
+			return &operator*();
+		}
+
+		IteradorConst &operator++() {
+			assert(_act != NULL);
+			_act = _act->_sig;
+			return *this;
+		}
+
+		IteradorConst operator++(int) {
+			IteradorConst ret(*this);
+			operator++();
+			return ret;
+		}
+	protected:
+		friend class Lista;
+
+		IteradorConst(const Nodo *act) : _act(act) {}
+
+		// Puntero al nodo actual del recorrido
+		const Nodo *_act;
+	};
 	
 	/**
 	 Devuelve el iterador al principio de la lista.
@@ -267,14 +457,40 @@ public:
 		return Iterador(_prim);
 	}
 
+	IteradorConst principio() const {
+		return IteradorConst(_prim);
+	}
+
 	/**
 	 @return Devuelve un iterador al final del recorrido
 	 (fuera de ste).
 	 */
-	Iterador final() const {
+	Iterador final() {
 		return Iterador(NULL);
 	}
 
+	IteradorConst final() const {
+		return IteradorConst(NULL);
+	}
+
+	/** Equivalentes a principio() y final() con los nombres
+	    de la STL, para los bucles for de rango. */
+	Iterador begin() {
+		return principio();
+	}
+
+	IteradorConst begin() const {
+		return principio();
+	}
+
+	Iterador end() {
+		return final();
+	}
+
+	IteradorConst end() const {
+		return final();
+	}
+
 	/**
 	 Permite eliminar de la lista el elemento
 	 apuntado por el iterador que se pasa como parmetro.
@@ -321,19 +537,85 @@ public:
 	 @param it Punto en el que insertar el elemento.
 	 */
 	void insertar(const T &elem, const Iterador &it) {
+		insertaAntes(it._act, elem);
+	}
 
-		// Caso especial: aadir al principio?
-		if (_prim == it._act) {
-			Cons(elem);
-		} else
-		// Caso especial: aadir al final?
-		if (it._act == NULL) {
-			ponDr(elem);
-		}
-		// Caso normal
-		else {
-			insertaElem(elem, it._act->_ant, it._act);
+	void insertar(T &&elem, const Iterador &it) {
+		insertaAntes(it._act, std::move(elem));
+	}
+
+	/**
+	 Como insertar, pero el elemento se construye
+	 directamente en su nodo a partir de "args".
+	 @param it Punto en el que insertar el elemento.
+	 @param args Argumentos para el constructor de T.
+	 */
+	template <class... Args>
+	void emplaza(const Iterador &it, Args&&... args) {
+		insertaAntes(it._act, std::forward<Args>(args)...);
+	}
+
+	/**
+	 Aade al final de la lista todos los elementos de
+	 other, que queda vaca. Los nodos no se copian sino
+	 que se enganchan tal cual, as que el coste es
+	 constante y los iteradores sobre other siguen
+	 apuntando a los mismos elementos (ahora en esta lista).
+	 Si las dos listas no usan el mismo almacn (ver Almacen)
+	 los elementos se tienen que mover a nodos nuevos, con
+	 coste lineal.
+	 @param other Lista cuyos elementos se aaden.
+	 */
+	void concatena(Lista<T> &other) {
+		empalma(final(), other);
+	}
+
+	/**
+	 Mueve todos los elementos de other a esta lista, _justo
+	 antes_ del elemento apuntado por it (como en insertar),
+	 en tiempo constante (si usan el mismo almacn, como en
+	 concatena). other queda vaca.
+	 @param it Punto de esta lista en el que se colocan.
+	 @param other Lista de la que se sacan los elementos.
+	 */
+	void empalma(const Iterador &it, Lista<T> &other) {
+		if ((&other == this) || other.esVacia())
+			return;
+		unsigned int num = other._numElems;
+		empalmaNodos(it, other, other._prim, other._ult, num);
+	}
+
+	/**
+	 Mueve los elementos de other que hay en el intervalo
+	 [ini, fin) a esta lista, _justo antes_ del elemento
+	 apuntado por it. Los nodos se desenganchan de other y se
+	 enganchan aqu sin copiar los elementos; el coste es
+	 proporcional al nmero de elementos movidos (hay que
+	 contarlos). other puede ser esta misma lista, siempre que
+	 it no est dentro del intervalo.
+	 @param it Punto de esta lista en el que se colocan.
+	 @param other Lista de la que se sacan los elementos.
+	 @param ini Primer elemento a mover (iterador sobre other).
+	 @param fin Elemento de other en el que termina el
+	 intervalo (no se mueve); puede ser other.final().
+	 */
+	void empalma(const Iterador &it, Lista<T> &other,
+			const Iterador &ini, const Iterador &fin) {
+		if (ini == fin)
+			return;
+		if (ini._act == NULL)
+			throw EAccesoInvalido();
+
+		// Buscamos el ltimo nodo del intervalo y contamos.
+		unsigned int num = 1;
+		Nodo *ult = ini._act;
+		while (ult->_sig != fin._act) {
+			ult = ult->_sig;
+			if (ult == NULL)
+				throw EAccesoInvalido();
+			++num;
 		}
+		empalmaNodos(it, other, ini._act, ult, num);
 	}
 
 	// //
@@ -342,10 +624,20 @@ public:
 	// //
 
 	/** Constructor copia */
-	Lista(const Lista<T> &other) : _prim(NULL), _ult(NULL) {
+	Lista(const Lista<T> &other) : _prim(NULL), _ult(NULL),
+			_almacen(NULL) {
 		copia(other);
 	}
 
+	/** Constructor de movimiento: se queda con los nodos de
+	    other (y con su almacn), y other queda vaca. */
+	Lista(Lista<T> &&other) : _prim(other._prim), _ult(other._ult),
+			_numElems(other._numElems),
+			_almacen(other._almacen) {
+		other._prim = other._ult = NULL;
+		other._numElems = 0;
+	}
+
 	/** Operador de asignacin */
 	Lista<T> &operator=(const Lista<T> &other) {
 		if (this != &other) {
@@ -355,6 +647,26 @@ public:
 		return *this;
 	}
 
+	/** Asignacin de movimiento. La lista conserva su almacn;
+	    si el de other es distinto, los elementos se mueven a
+	    nodos nuevos. */
+	Lista<T> &operator=(Lista<T> &&other) {
+		if (this != &other) {
+			libera();
+			if (_almacen == other._almacen) {
+				_prim = other._prim;
+				_ult = other._ult;
+				_numElems = other._numElems;
+				other._prim = other._ult = NULL;
+				other._numElems = 0;
+			} else {
+				_numElems = 0;
+				concatena(other);
+			}
+		}
+		return *this;
+	}
+
 	/** Operador de comparacin. */
 	bool operator==(const Lista<T> &rhs) const {
 		if (_numElems != rhs._numElems)
@@ -399,9 +711,75 @@ protected:
 
 private:
 
+	/**
+	 Desengancha de other los nodos consecutivos [prim..ult],
+	 que contienen num elementos, y los engancha en esta
+	 lista justo antes de it.
+	 */
+	void empalmaNodos(const Iterador &it, Lista<T> &other,
+			Nodo *prim, Nodo *ult, unsigned int num) {
+		// Los quitamos de other.
+		if (prim->_ant != NULL)
+			prim->_ant->_sig = ult->_sig;
+		else
+			other._prim = ult->_sig;
+		if (ult->_sig != NULL)
+			ult->_sig->_ant = prim->_ant;
+		else
+			other._ult = prim->_ant;
+		other._numElems -= num;
+
+		// Y los ponemos delante de it._act (o al final).
+		Nodo *ant = (it._act != NULL) ? it._act->_ant : _ult;
+		prim->_ant = ant;
+		ult->_sig = it._act;
+		if (ant != NULL)
+			ant->_sig = prim;
+		else
+			_prim = prim;
+		if (it._act != NULL)
+			it._act->_ant = ult;
+		else
+			_ult = ult;
+		_numElems += num;
+
+		// Si los almacenes son distintos, cambiamos los nodos
+		// recibidos por otros de nuestro almacn.
+		if (other._almacen != _almacen) {
+			Nodo *fin = ult->_sig;
+			Nodo *act = prim;
+			while (act != fin) {
+				Nodo *sig = act->_sig;
+				Nodo *nuevo = insertaElem(act->_ant, sig, std::move(act->_elem));
+				if (_prim == act)
+					_prim = nuevo;
+				if (_ult == act)
+					_ult = nuevo;
+				other.destruyeNodo(act);
+				act = sig;
+			}
+		}
+	}
 
 	/**
-	 Inserta un elemento entre el nodo1 y el nodo2.
+	 Inserta un elemento construido a partir de "args"
+	 justo antes del nodo sig (al final si es NULL),
+	 actualizando _prim, _ult y el nmero de elementos.
+	 */
+	template <class... Args>
+	void insertaAntes(Nodo *sig, Args&&... args) {
+		Nodo *ant = (sig != NULL) ? sig->_ant : _ult;
+		Nodo *nuevo = insertaElem(ant, sig, std::forward<Args>(args)...);
+		if (ant == NULL)
+			_prim = nuevo;
+		if (sig == NULL)
+			_ult = nuevo;
+		_numElems++;
+	}
+
+	/**
+	 Inserta un elemento construido a partir de "args"
+	 entre el nodo1 y el nodo2.
 	 Devuelve el puntero al nodo creado.
 	 Caso general: los dos nodos existen.
 	    nodo1->_sig == nodo2
@@ -409,8 +787,9 @@ private:
 	 Casos especiales: alguno de los nodos no existe
 	    nodo1 == NULL y/o nodo2 == NULL
 	*/
-	static Nodo *insertaElem(const T &e, Nodo *nodo1, Nodo *nodo2) {
-		Nodo *nuevo = new Nodo(nodo1, e, nodo2);
+	template <class... Args>
+	Nodo *insertaElem(Nodo *nodo1, Nodo *nodo2, Args&&... args) {
+		Nodo *nuevo = creaNodo(nodo1, nodo2, std::forward<Args>(args)...);
 		if (nodo1 != NULL)
 			nodo1->_sig = nuevo;
 		if (nodo2 != NULL)
@@ -425,7 +804,7 @@ private:
 	 Casos especiales: algunos de los nodos (anterior o siguiente
 	 a n) no existen.
 	*/
-	static void borraElem(Nodo *n) {
+	void borraElem(Nodo *n) {
 		assert(n != NULL);
 		Nodo *ant = n->_ant;
 		Nodo *sig = n->_sig;
@@ -433,7 +812,7 @@ private:
 			ant->_sig = sig;
 		if (sig != NULL)
 			sig->_ant = ant;
-		delete n;
+		destruyeNodo(n);
 	}
 
 	/**
@@ -443,22 +822,80 @@ private:
 	 liberar). En caso de pasarse un nodo vlido,
 	 su puntero al nodo anterior debe ser NULL (si no,
 	 no sera el primero de la lista!).
+	 Tambin con almacn se recorren los nodos uno a uno:
+	 cada hueco tiene que volver a la lista de libres para
+	 que lo reutilicen las dems listas, y slo al destruir
+	 el almacn se devuelve la memoria de golpe.
 	 */
-	static void libera(Nodo *prim) {
+	void libera(Nodo *prim) {
 		assert(!prim || !prim->_ant);
 
 		while (prim != NULL) {
 			Nodo *aux = prim;
 			prim = prim->_sig;
-			delete aux;
+			destruyeNodo(aux);
 		}
 	}
 
+	/**
+	 Devuelve el nodo de la posicin idx (implementacin de
+	 elem), empezando por el ms cercano de _prim, _ult y
+	 "desde", que si no es NULL est en la posicin idxDesde.
+	 */
+	const Nodo *buscaNodo(unsigned int idx, const Nodo *desde,
+			unsigned int idxDesde) const {
+		if (idx >= _numElems)
+			throw EAccesoInvalido();
+
+		const Nodo *aux = _prim;
+		unsigned int pos = 0;
+		unsigned int dist = idx;
+		if (_numElems - 1 - idx < dist) {
+			aux = _ult;
+			pos = _numElems - 1;
+			dist = pos - idx;
+		}
+		if ((desde != NULL) &&
+				((idx > idxDesde ? idx - idxDesde : idxDesde - idx) < dist)) {
+			aux = desde;
+			pos = idxDesde;
+		}
+
+		for (; pos < idx; ++pos)
+			aux = aux->_sig;
+		for (; pos > idx; --pos)
+			aux = aux->_ant;
+		return aux;
+	}
+
+	/**
+	 Crea un nodo con los argumentos dados, en el almacn de
+	 la lista si tiene uno.
+	 */
+	template <class... Args>
+	Nodo *creaNodo(Args&&... args) {
+		if (_almacen != NULL)
+			return _almacen->crea(std::forward<Args>(args)...);
+		return new Nodo(std::forward<Args>(args)...);
+	}
+
+	/** Destruye un nodo creado con creaNodo. */
+	void destruyeNodo(Nodo *n) {
+		if (_almacen != NULL)
+			_almacen->destruye(n);
+		else
+			delete n;
+	}
+
 	// Puntero al primer y ltimo elemento
 	Nodo *_prim, *_ult;
 
 	// Nmero de elementos (nmero de nodos entre _prim y _ult)
 	unsigned int _numElems;
+
+	// Almacn del que salen los nodos, o NULL si se crean
+	// con new
+	Almacen *_almacen;
 };
 
 #endif // __LISTA_ENLAZADA_H
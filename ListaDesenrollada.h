@@ -0,0 +1,654 @@
+/**
+  @file ListaDesenrollada.h
+
+  Implementacin del TAD lista, utilizando una lista
+  doblemente enlazada de nodos que guardan varios
+  elementos cada uno (lista "desenrollada").
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __LISTA_DESENROLLADA_H
+#define __LISTA_DESENROLLADA_H
+
+#include "Excepciones.h"
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ Implementacin del TAD Lista con las mismas operaciones que
+ Lista, pero en la que cada nodo guarda hasta N elementos
+ seguidos en lugar de uno solo. Para tipos pequeos (por
+ ejemplo las listas de adyacencia de enteros de los grafos)
+ los punteros de cada nodo se reparten entre muchos
+ elementos, la memoria ocupada es varias veces menor y al
+ recorrer la lista los elementos consecutivos suelen estar
+ en la misma lnea de cach.
+
+ Por defecto N se elige para que los elementos de un nodo
+ ocupen unos 128 bytes (y al menos haya 4 por nodo).
+
+ Las operaciones son:
+
+ - ListaVacia: -> Lista. Generadora implementada en el
+   constructor sin parmetros.
+ - Cons: Lista, Elem -> Lista. Generadora.
+ - ponDr: Lista, Elem -> Lista. Modificadora.
+ - primero: Lista - -> Elem. Observadora parcial
+ - resto: Lista - -> Lista. Modificadora parcial
+ - ultimo: Lista - -> Elem. Observadora parcial
+ - inicio: Lista - -> Lista. Modificadora parcial
+ - esVacia: Lista -> Bool. Observadora
+ - numElems: Lista -> Elem. Obervadora.
+ - elem: Lista, Entero - -> Elem. Observador parcial.
+
+ A diferencia de Lista, insertar y borra desplazan los
+ elementos dentro de su nodo, as que invalidan todos los
+ iteradores salvo el que devuelven.
+ */
+template <class T,
+		unsigned int N = (128 / sizeof(T) > 4) ? 128 / sizeof(T) : 4>
+class ListaDesenrollada {
+private:
+	/**
+	 Clase nodo que almacena hasta N elementos (de tipo T)
+	 en un array, cuntos de ellos estn ocupados, y dos
+	 punteros, uno al nodo anterior y otro al nodo siguiente.
+	 Los elementos ocupados son siempre los _n primeros del
+	 array. Ningn nodo de la lista est vaco.
+	 */
+	class Nodo {
+	public:
+		Nodo() : _n(0), _sig(NULL), _ant(NULL) {}
+
+		~Nodo() {
+			for (unsigned int i = 0; i < _n; ++i)
+				elem(i).~T();
+		}
+
+		T &elem(unsigned int i) {
+			return *reinterpret_cast<T *>(&_datos[i]);
+		}
+
+		const T &elem(unsigned int i) const {
+			return *reinterpret_cast<const T *>(&_datos[i]);
+		}
+
+		/**
+		 Inserta e en la posicin i, desplazando una
+		 posicin a la derecha los elementos [i.._n-1].
+		 El nodo debe tener sitio libre.
+		 */
+		void inserta(unsigned int i, const T &e) {
+			assert(_n < N);
+			if (i == _n) {
+				new (&_datos[_n]) T(e);
+			} else {
+				// Copiamos e antes de desplazar por si es
+				// uno de los elementos del propio nodo.
+				T copia(e);
+				new (&_datos[_n]) T(std::move(elem(_n - 1)));
+				for (unsigned int j = _n - 1; j > i; --j)
+					elem(j) = std::move(elem(j - 1));
+				elem(i) = std::move(copia);
+			}
+			++_n;
+		}
+
+		/**
+		 Elimina el elemento de la posicin i desplazando
+		 una posicin a la izquierda los siguientes.
+		 */
+		void borra(unsigned int i) {
+			assert(i < _n);
+			for (unsigned int j = i; j + 1 < _n; ++j)
+				elem(j) = std::move(elem(j + 1));
+			--_n;
+			elem(_n).~T();
+		}
+
+		/**
+		 Mueve al final de este nodo los elementos de otro
+		 a partir de la posicin desde (incluida), que quedan
+		 eliminados de l.
+		 */
+		void traeDe(Nodo *otro, unsigned int desde) {
+			assert(_n + otro->_n - desde <= N);
+			for (unsigned int j = desde; j < otro->_n; ++j) {
+				new (&_datos[_n++]) T(std::move(otro->elem(j)));
+				otro->elem(j).~T();
+			}
+			otro->_n = desde;
+		}
+
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type _datos[N];
+		unsigned int _n;
+		Nodo *_sig;
+		Nodo *_ant;
+	};
+
+public:
+
+	/** Constructor; operacin ListaVacia. */
+	ListaDesenrollada() : _prim(NULL), _ult(NULL), _numElems(0) {}
+
+	/** Destructor; elimina la lista de nodos. */
+	~ListaDesenrollada() {
+		libera();
+	}
+
+	/**
+	 Aade un nuevo elemento en la cabeza de la lista.
+	 Operacin generadora.
+
+	 @param elem Elemento que se aade en la cabecera de
+	 la lista.
+	*/
+	void Cons(const T &elem) {
+		if ((_prim == NULL) || (_prim->_n == N))
+			nuevoNodo(NULL, _prim);
+		_prim->inserta(0, elem);
+		_numElems++;
+	}
+
+	/**
+	 Aade un nuevo elemento al final de la lista (a la
+	 "derecha"). Operacin modificadora.
+
+	 ponDr(e, ListaVacia) = Cons(e, ListaVacia)
+	 ponDr(e, Cons(x, xs)) = Cons(x, ponDr(e, xs))
+	*/
+	void ponDr(const T &elem) {
+		if ((_ult == NULL) || (_ult->_n == N))
+			nuevoNodo(_ult, NULL);
+		_ult->inserta(_ult->_n, elem);
+		_numElems++;
+	}
+
+	/**
+	 Devuelve el valor almacenado en la cabecera de la
+	 lista. Es un error preguntar por el primero de
+	 una lista vaca.
+
+	 @return Elemento en la cabecera de la lista.
+	 */
+	const T &primero() const {
+		if (esVacia())
+			throw EListaVacia();
+		return _prim->elem(0);
+	}
+
+	/**
+	 Devuelve el valor almacenado en la ltima posicin
+	 de la lista (a la derecha).
+	 Es un error preguntar por el ltimo de una lista vaca.
+
+	 @return Elemento en la cola de la lista.
+	 */
+	const T &ultimo() const {
+		if (esVacia())
+			throw EListaVacia();
+		return _ult->elem(_ult->_n - 1);
+	}
+
+	/**
+	 Elimina el primer elemento de la lista.
+	 Es un error intentar obtener el resto de una lista vaca.
+	*/
+	void resto() {
+		if (esVacia())
+			throw EListaVacia();
+		borraDe(_prim, 0);
+	}
+
+	/**
+	 Elimina el ltimo elemento de la lista.
+	 Es un error intentar obtener el inicio de una lista vaca.
+	*/
+	void inicio() {
+		if (esVacia())
+			throw EListaVacia();
+		borraDe(_ult, _ult->_n - 1);
+	}
+
+	/**
+	 Operacin observadora para saber si una lista
+	 tiene o no elementos.
+
+	 @return true si la lista no tiene elementos.
+	 */
+	bool esVacia() const {
+		return _prim == NULL;
+	}
+
+	/**
+	 Devuelve el nmero de elementos que hay en la
+	 lista.
+
+	 @return Nmero de elementos.
+	 */
+	unsigned int numElems() const {
+		return _numElems;
+	}
+
+	/**
+	 Devuelve el elemento i-simo de la lista, con idx
+	 en [0..numElems()-1]. Se salta de nodo en nodo, as
+	 que el coste es de O(idx / N) saltos.
+
+	 error elem(n, xs) si !( 0 <= n < numElems(xs) )
+	*/
+	const T &elem(unsigned int idx) const {
+		if (idx >= _numElems)
+			throw EAccesoInvalido();
+
+		Nodo *aux = _prim;
+		while (idx >= aux->_n) {
+			idx -= aux->_n;
+			aux = aux->_sig;
+		}
+		return aux->elem(idx);
+	}
+
+	/**
+	 Clase interna que implementa un iterador sobre
+	 la lista que permite recorrer la lista e incluso
+	 alterar el valor de sus elementos. Como el de Lista,
+	 tambin es un iterador de avance de la STL, y las
+	 listas constantes devuelven en su lugar un
+	 IteradorConst.
+	 */
+	class IteradorConst;
+
+	class Iterador {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef T *pointer;
+		typedef T &reference;
+
+		/** Iterador fuera de la lista (como final()). */
+		Iterador() : _act(NULL), _pos(0) {}
+
+		void avanza() {
+			if (_act == NULL) throw EAccesoInvalido();
+			if (++_pos == _act->_n) {
+				_act = _act->_sig;
+				_pos = 0;
+			}
+		}
+
+		const T &elem() const {
+			if (_act == NULL) throw EAccesoInvalido();
+			return _act->elem(_pos);
+		}
+
+		void pon(const T &elem) {
+			if (_act == NULL) throw EAccesoInvalido();
+			_act->elem(_pos) = elem;
+		}
+
+		bool operator==(const Iterador &other) const {
+			return (_act == other._act) && (_pos == other._pos);
+		}
+
+		bool operator!=(const Iterador &other) const {
+			return !(this->operator==(other));
+		}
+
+		T &operator*() const {
+			assert(_act != NULL);
+			return _act->elem(_pos);
+		}
+
+		T *operator->() const {
+			return &operator*();
+		}
+
+		Iterador &operator++() {
+			assert(_act != NULL);
+			if (++_pos == _act->_n) {
+				_act = _act->_sig;
+				_pos = 0;
+			}
+			return *this;
+		}
+
+		Iterador operator++(int) {
+			Iterador ret(*this);
+			operator++();
+			return ret;
+		}
+	protected:
+		// Para que pueda construir objetos del
+		// tipo iterador
+		friend class ListaDesenrollada;
+		friend class IteradorConst;
+
+		Iterador(Nodo *act, unsigned int pos) : _act(act), _pos(pos) {}
+
+		// Si la posicin se ha quedado al final del nodo,
+		// pasa al primer elemento del siguiente.
+		Iterador &normaliza() {
+			if ((_act != NULL) && (_pos == _act->_n)) {
+				_act = _act->_sig;
+				_pos = 0;
+			}
+			return *this;
+		}
+
+		// Nodo actual del recorrido y posicin dentro de l
+		Nodo *_act;
+		unsigned int _pos;
+	};
+
+	/**
+	 Iterador que recorre la lista sin poder alterarla (sin
+	 pon y con *it constante), como el de Lista.
+	 */
+	class IteradorConst {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const T *pointer;
+		typedef const T &reference;
+
+		/** Iterador fuera de la lista (como final()). */
+		IteradorConst() : _act(NULL), _pos(0) {}
+
+		IteradorConst(const Iterador &it) : _act(it._act), _pos(it._pos) {}
+
+		void avanza() {
+			if (_act == NULL) throw EAccesoInvalido();
+			operator++();
+		}
+
+		const T &elem() const {
+			if (_act == NULL) throw EAccesoInvalido();
+			return _act->elem(_pos);
+		}
+
+		bool operator==(const IteradorConst &other) const {
+			return (_act == other._act) && (_pos == other._pos);
+		}
+
+		bool operator!=(const IteradorConst &other) const {
+			return !(this->operator==(other));
+		}
+
+		const T &operator*() const {
+			assert(_act != NULL);
+			return _act->elem(_pos);
+		}
+
+		const T *operator->() const {
+			return &operator*();
+		}
+
+		IteradorConst &operator++() {
+			assert(_act != NULL);
+			if (++_pos == _act->_n) {
+				_act = _act->_sig;
+				_pos = 0;
+			}
+			return *this;
+		}
+
+		IteradorConst operator++(int) {
+			IteradorConst ret(*this);
+			operator++();
+			return ret;
+		}
+	protected:
+		friend class ListaDesenrollada;
+
+		IteradorConst(const Nodo *act, unsigned int pos) : _act(act), _pos(pos) {}
+
+		// Nodo actual del recorrido y posicin dentro de l
+		const Nodo *_act;
+		unsigned int _pos;
+	};
+
+	/**
+	 Devuelve el iterador al principio de la lista.
+	 @return iterador al principio de la lista;
+	 coincidir con final() si la lista est vaca.
+	 */
+	Iterador principio() {
+		return Iterador(_prim, 0);
+	}
+
+	IteradorConst principio() const {
+		return IteradorConst(_prim, 0);
+	}
+
+	/**
+	 @return Devuelve un iterador al final del recorrido
+	 (fuera de ste).
+	 */
+	Iterador final() {
+		return Iterador(NULL, 0);
+	}
+
+	IteradorConst final() const {
+		return IteradorConst(NULL, 0);
+	}
+
+	/** Equivalentes a principio() y final() con los nombres
+	    de la STL, para los bucles for de rango. */
+	Iterador begin() {
+		return principio();
+	}
+
+	IteradorConst begin() const {
+		return principio();
+	}
+
+	Iterador end() {
+		return final();
+	}
+
+	IteradorConst end() const {
+		return final();
+	}
+
+	/**
+	 Permite eliminar de la lista el elemento
+	 apuntado por el iterador que se pasa como parmetro.
+	 El iterador recibido (y cualquier otro sobre la lista)
+	 DEJA DE SER VLIDO. En su lugar, deber utilizarse el
+	 iterador devuelto, que apuntar al siguiente elemento
+	 al borrado.
+	 @param it Iterador colocado en el elemento que se
+	 quiere borrar.
+	 @return Nuevo iterador colocado en el elemento siguiente
+	 al borrado (podra coincidir con final() si el
+	 elemento que se borr era el ltimo de la lista).
+	 */
+	Iterador borra(const Iterador &it) {
+		if (it._act == NULL)
+			throw EAccesoInvalido();
+		return borraDe(it._act, it._pos);
+	}
+
+	/**
+	 Mtodo para insertar un elemento en la lista
+	 en el punto marcado por el iterador. En concreto,
+	 se aade _justo antes_ que el elemento actual. Si
+	 it==l.final(), el elemento insertado ser el ltimo.
+	 Los iteradores sobre la lista dejan de ser vlidos;
+	 se devuelve uno que apunta al mismo elemento que
+	 apuntaba it.
+	 @param elem Valor del elemento a insertar.
+	 @param it Punto en el que insertar el elemento.
+	 @return iterador al elemento que segua al insertado.
+	 */
+	Iterador insertar(const T &elem, const Iterador &it) {
+		if (it._act == NULL) {
+			ponDr(elem);
+			return final();
+		}
+
+		Nodo *nodo = it._act;
+		unsigned int pos = it._pos;
+
+		// Si el nodo est lleno lo partimos en dos mitades
+		// y seguimos con la que contiene la posicin.
+		if (nodo->_n == N) {
+			Nodo *nuevo = nuevoNodo(nodo, nodo->_sig);
+			nuevo->traeDe(nodo, N / 2);
+			if (pos >= N / 2) {
+				nodo = nuevo;
+				pos -= N / 2;
+			}
+		}
+
+		nodo->inserta(pos, elem);
+		_numElems++;
+		return Iterador(nodo, pos + 1).normaliza();
+	}
+
+	// //
+	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
+	// A LA CLASE
+	// //
+
+	/** Constructor copia */
+	ListaDesenrollada(const ListaDesenrollada<T, N> &other) :
+			_prim(NULL), _ult(NULL), _numElems(0) {
+		copia(other);
+	}
+
+	/** Operador de asignacin */
+	ListaDesenrollada<T, N> &operator=(const ListaDesenrollada<T, N> &other) {
+		if (this != &other) {
+			libera();
+			copia(other);
+		}
+		return *this;
+	}
+
+	/** Operador de comparacin. */
+	bool operator==(const ListaDesenrollada<T, N> &rhs) const {
+		if (_numElems != rhs._numElems)
+			return false;
+		Nodo *p1 = _prim, *p2 = rhs._prim;
+		unsigned int i1 = 0, i2 = 0;
+		while ((p1 != NULL) && (p2 != NULL)) {
+			if (p1->elem(i1) != p2->elem(i2))
+				return false;
+			if (++i1 == p1->_n) { p1 = p1->_sig; i1 = 0; }
+			if (++i2 == p2->_n) { p2 = p2->_sig; i2 = 0; }
+		}
+
+		return (p1 == NULL) && (p2 == NULL);
+	}
+
+	bool operator!=(const ListaDesenrollada<T, N> &rhs) const {
+		return !(*this == rhs);
+	}
+
+
+protected:
+
+	void libera() {
+		while (_prim != NULL) {
+			Nodo *aux = _prim;
+			_prim = _prim->_sig;
+			delete aux;
+		}
+		_ult = NULL;
+		_numElems = 0;
+	}
+
+	void copia(const ListaDesenrollada<T, N> &other) {
+		// Los nodos se copian llenos, aunque los de other
+		// no lo estuvieran.
+		_prim = _ult = NULL;
+		_numElems = 0;
+
+		for (Nodo *act = other._prim; act != NULL; act = act->_sig)
+			for (unsigned int i = 0; i < act->_n; ++i)
+				ponDr(act->elem(i));
+	}
+
+private:
+
+	/**
+	 Crea un nodo vaco entre nodo1 y nodo2 (cualquiera de
+	 los dos puede ser NULL) y actualiza _prim y _ult si
+	 hace falta.
+	 @return el nodo creado.
+	 */
+	Nodo *nuevoNodo(Nodo *nodo1, Nodo *nodo2) {
+		Nodo *nuevo = new Nodo();
+		nuevo->_ant = nodo1;
+		nuevo->_sig = nodo2;
+		if (nodo1 != NULL)
+			nodo1->_sig = nuevo;
+		else
+			_prim = nuevo;
+		if (nodo2 != NULL)
+			nodo2->_ant = nuevo;
+		else
+			_ult = nuevo;
+		return nuevo;
+	}
+
+	/**
+	 Elimina el nodo n, que debe estar vaco, y actualiza
+	 los punteros de sus vecinos, _prim y _ult.
+	 */
+	void quitaNodo(Nodo *n) {
+		assert(n->_n == 0);
+		if (n->_ant != NULL)
+			n->_ant->_sig = n->_sig;
+		else
+			_prim = n->_sig;
+		if (n->_sig != NULL)
+			n->_sig->_ant = n->_ant;
+		else
+			_ult = n->_ant;
+		delete n;
+	}
+
+	/**
+	 Elimina el elemento pos del nodo dado. Si el nodo queda
+	 vaco se elimina, y si entre l y el siguiente quedan
+	 como mucho N/2 elementos se juntan en uno, para que los
+	 borrados no dejen la lista llena de nodos casi vacos.
+	 @return iterador al elemento siguiente al borrado.
+	 */
+	Iterador borraDe(Nodo *nodo, unsigned int pos) {
+		nodo->borra(pos);
+		--_numElems;
+
+		if (nodo->_n == 0) {
+			Nodo *sig = nodo->_sig;
+			quitaNodo(nodo);
+			return Iterador(sig, 0);
+		}
+
+		Nodo *sig = nodo->_sig;
+		if ((sig != NULL) && (nodo->_n + sig->_n <= N / 2)) {
+			nodo->traeDe(sig, 0);
+			quitaNodo(sig);
+		}
+		return Iterador(nodo, pos).normaliza();
+	}
+
+	// Puntero al primer y ltimo nodo
+	Nodo *_prim, *_ult;
+
+	// Nmero de elementos (suma de los _n de los nodos)
+	unsigned int _numElems;
+};
+
+#endif // __LISTA_DESENROLLADA_H
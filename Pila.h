@@ -15,6 +15,10 @@
 #define __PILA_H
 
 #include "Excepciones.h"
+#include "Traslado.h"
+#include <cstdlib>
+#include <new>
+#include <utility>
 
 /**
  Implementacin del TAD Pila utilizando vectores dinmicos.
@@ -24,11 +28,21 @@
  - PilaVacia: -> Pila. Generadora implementada en el
    constructor sin parmetros.
  - apila: Pila, Elem -> Pila. Generadora
+   (tambin emplaza, que construye el elemento en la pila)
  - desapila: Pila - -> Pila. Modificadora parcial.
  - cima: Pila - -> Elem. Observadora parcial.
  - esVacia: Pila -> Bool. Observadora.
  - numElems: Pila -> Entero. Observadora.
 
+ Las posiciones libres del vector no contienen objetos: los
+ elementos se construyen al apilarlos y se destruyen al
+ desapilarlos. Cuando el vector se llena se dobla su tamao
+ y los elementos se mueven al nuevo (con memcpy si T se
+ puede copiar byte a byte). Opcionalmente el vector tambin
+ se reduce a la mitad cuando slo queda ocupado un cuarto,
+ para devolver la memoria tras un pico sin tener que volver
+ a crecer en cuanto se apile de nuevo.
+
  @author Marco Antonio Gmez Martn
  */
 template <class T>
@@ -38,8 +52,9 @@ public:
 	/** Tamao inicial del vector dinmico. */
 	enum { TAM_INICIAL = 10 };
 
-	/** Constructor; operacin PilaVacia */
-	Pila() {
+	/** Constructor; operacin PilaVacia. No reserva memoria
+	    hasta que se apila el primer elemento. */
+	Pila() : _reduce(false) {
 		inicia();
 	}
 
@@ -54,9 +69,29 @@ public:
 	 @param elem Elemento a apilar.
 	*/
 	void apila(const T &elem) {
-		if (_numElems == _tam)
-			amplia();
-		_v[_numElems] = elem;
+		emplaza(elem);
+	}
+
+	/** Igual que el anterior, pero mueve el elemento a la
+	    pila en lugar de copiarlo. */
+	void apila(T &&elem) {
+		emplaza(std::move(elem));
+	}
+
+	/**
+	 Apila un elemento construido directamente en su posicin
+	 a partir de "args".
+	 */
+	template <class... Args>
+	void emplaza(Args&&... args) {
+		if (_numElems == _tam) {
+			// elem puede ser un elemento de la propia pila, as
+			// que se construye antes de cambiar de vector.
+			T elem(std::forward<Args>(args)...);
+			redimensiona(_tam == 0 ? (unsigned int) TAM_INICIAL : 2 * _tam);
+			new (&_v[_numElems]) T(std::move(elem));
+		} else
+			new (&_v[_numElems]) T(std::forward<Args>(args)...);
 		_numElems++;
 	}
 	
@@ -71,6 +106,9 @@ public:
 		if (esVacia())
 			throw EPilaVacia();
 		--_numElems;
+		_v[_numElems].~T();
+		if (_reduce && _tam > TAM_INICIAL && _numElems <= _tam / 4)
+			redimensiona(_tam / 2);
 	}
 
 	/**
@@ -88,6 +126,13 @@ public:
 		return _v[_numElems - 1];
 	}
 
+	/** Igual que el anterior, pero permite modificar la cima. */
+	T &cima() {
+		if (esVacia())
+			throw EPilaVacia();
+		return _v[_numElems - 1];
+	}
+
 	/**
 	 Devuelve true si la pila no tiene ningn elemento.
 
@@ -112,21 +157,72 @@ public:
 		return _numElems;
 	}
 
+	/**
+	 Prepara el vector para guardar n elementos sin volver
+	 a crecer.
+	 */
+	void reserva(unsigned int n) {
+		if (n > _tam)
+			redimensiona(n);
+	}
+
+	/**
+	 Ajusta el tamao del vector al nmero de elementos,
+	 devolviendo la memoria que sobra.
+	 */
+	void ajusta() {
+		if (_numElems < _tam)
+			redimensiona(_numElems);
+	}
+
+	/**
+	 Activa o desactiva la reduccin automtica del vector:
+	 si est activa, desapila lo reduce a la mitad cuando
+	 slo queda ocupado un cuarto (y es mayor que el tamao
+	 inicial). Por defecto est desactivada.
+	 */
+	void reduccionAutomatica(bool activa) {
+		_reduce = activa;
+	}
+
 	// //
 	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
 	// A LA CLASE
 	// //
 
 	/** Constructor copia */
-	Pila(const Pila<T> &other) {
+	Pila(const Pila<T> &other) : _reduce(other._reduce) {
 		copia(other);
 	}
 
+	/** Constructor de movimiento: se queda con el vector de
+	    other, que queda vaca (y sin vector). */
+	Pila(Pila<T> &&other) : _v(other._v), _tam(other._tam),
+			_numElems(other._numElems), _reduce(other._reduce) {
+		other._v = NULL;
+		other._tam = other._numElems = 0;
+	}
+
 	/** Operador de asignacin */
 	Pila<T> &operator=(const Pila<T> &other) {
 		if (this != &other) {
 			libera();
 			copia(other);
+			_reduce = other._reduce;
+		}
+		return *this;
+	}
+
+	/** Asignacin de movimiento */
+	Pila<T> &operator=(Pila<T> &&other) {
+		if (this != &other) {
+			libera();
+			_v = other._v;
+			_tam = other._tam;
+			_numElems = other._numElems;
+			_reduce = other._reduce;
+			other._v = NULL;
+			other._tam = other._numElems = 0;
 		}
 		return *this;
 	}
@@ -148,33 +244,41 @@ public:
 protected:
 
 	void inicia() {
-		_v = new T[TAM_INICIAL];
-		_tam = TAM_INICIAL;
+		_v = NULL;
+		_tam = 0;
 		_numElems = 0;
 	}
 
 	void libera() {
-		delete []_v;
-		_v = NULL;
+		for (unsigned int i = 0; i < _numElems; ++i)
+			_v[i].~T();
+		free(_v);
+		inicia();
 	}
 
 	void copia(const Pila &other) {
-		_tam = other._numElems + TAM_INICIAL;
-		_numElems = other._numElems;
-		_v = new T[_tam];
-		for (unsigned int i = 0; i < _numElems; ++i)
-			_v[i] = other._v[i];
+		inicia();
+		if (other._numElems > 0)
+			redimensiona(other._numElems);
+		for (; _numElems < other._numElems; ++_numElems)
+			new (&_v[_numElems]) T(other._v[_numElems]);
 	}
 
-	void amplia() {
-		T *viejo = _v;
-		_tam *= 2;
-		_v = new T[_tam];
-
-		for (unsigned int i = 0; i < _numElems; ++i)
-			_v[i] = viejo[i];
-
-		delete []viejo;
+	/**
+	 Cambia el vector por otro de tamao "tam" (que debe ser
+	 al menos _numElems) y traslada a l los elementos.
+	 */
+	void redimensiona(unsigned int tam) {
+		T *nuevo = NULL;
+		if (tam > 0) {
+			nuevo = static_cast<T *>(malloc(tam * sizeof(T)));
+			if (nuevo == NULL)
+				throw std::bad_alloc();
+		}
+		trasladaElems(nuevo, _v, _numElems);
+		free(_v);
+		_v = nuevo;
+		_tam = tam;
 	}
 
 private:
@@ -187,6 +291,9 @@ private:
 
 	/** Nmero de elementos reales guardados. */
 	unsigned int _numElems;
+
+	/** Si desapila reduce el vector (ver reduccionAutomatica). */
+	bool _reduce;
 };
 
 #endif // __PILA_H
@@ -0,0 +1,92 @@
+/*
+ * PilaDFS.h
+ *
+ * Pila explcita para los recorridos en profundidad de los grafos.
+ */
+
+#ifndef PILADFS_H_
+#define PILADFS_H_
+
+#include "Pila.h"
+
+#include <utility>
+
+typedef unsigned int uint;
+
+/**
+ * Pila de los vrtices abiertos en un recorrido en profundidad, con la
+ * posicin por la que va cada uno en su lista de adyacentes. Sustituye
+ * a la pila de llamadas de la versin recursiva, que en grafos con
+ * caminos de millones de vrtices desborda la pila del hilo.
+ *
+ * Los vrtices se apilan y desapilan en el mismo orden en el que la
+ * versin recursiva entra y sale de dfs, as que los rdenes (pre, post
+ * y postorden inverso) son los mismos. El esquema es siempre:
+ *
+ *   visitar s; pila.apila(G, s);
+ *   while (!pila.esVacia())
+ *       if (!pila.siguiente(w)) { terminar pila.cima(); pila.desapila(); }
+ *       else if (w no visitado) { visitar w; pila.apila(G, w); }
+ *
+ * Los marcos se guardan seguidos en una Pila, que no devuelve la
+ * memoria al vaciarse: la misma PilaDFS se reutiliza en todos los
+ * recorridos que lanza un algoritmo (por ejemplo, uno por componente).
+ *
+ * TipoGrafo es cualquier grafo cuyo adj(v) se pueda recorrer con
+ * begin/end (Grafo, GrafoDirigido, GrafoCSR).
+ */
+template <class TipoGrafo>
+class PilaDFS {
+public:
+
+	/** Iterador sobre los adyacentes de un vrtice de TipoGrafo. */
+	typedef decltype(std::declval<const TipoGrafo &>().adj(0).begin()) Iterador;
+
+	/** Abre el vrtice v: sus adyacentes se recorrern desde el primero. */
+	void apila(const TipoGrafo &G, uint v) {
+		const auto &ady = G.adj(v);
+		_pila.emplaza(v, ady.begin(), ady.end());
+	}
+
+	/**
+	 * Devuelve en w el siguiente adyacente del vrtice de la cima y
+	 * avanza. Si ya no le quedan devuelve false (hay que desapilarlo).
+	 */
+	bool siguiente(uint &w) {
+		Marco &m = _pila.cima();
+		if (m._it == m._fin)
+			return false;
+		w = *m._it;
+		++m._it;
+		return true;
+	}
+
+	/** Vrtice de la cima. */
+	uint cima() const { return _pila.cima()._v; }
+
+	/** Cierra el vrtice de la cima. */
+	void desapila() { _pila.desapila(); }
+
+	/** Elimina todos los vrtices abiertos. */
+	void vacia() {
+		while (!_pila.esVacia())
+			_pila.desapila();
+	}
+
+	bool esVacia() const { return _pila.esVacia(); }
+
+private:
+
+	/** Vrtice abierto y adyacentes que le quedan por mirar. */
+	struct Marco {
+		Marco(uint v, const Iterador &it, const Iterador &fin) :
+				_v(v), _it(it), _fin(fin) {}
+
+		uint _v;
+		Iterador _it, _fin;
+	};
+
+	Pila<Marco> _pila;
+};
+
+#endif /* PILADFS_H_ */
@@ -14,6 +14,8 @@
 #define __PILA_LISTA_ENLAZADA_H
 
 #include "Excepciones.h"
+#include "PoolNodos.h"
+#include <utility>
 
 /**
  Implementacin del TAD Pila utilizando vectores dinmicos.
@@ -23,6 +25,7 @@
  - PilaVacia: -> Pila. Generadora implementada en el
    constructor sin parmetros.
  - apila: Pila, Elem -> Pila. Generadora
+   (tambin emplaza, que construye el elemento en la pila)
  - desapila: Pila - -> Pila. Modificadora parcial.
  - cima: Pila - -> Elem. Observadora parcial.
  - esVacia: Pila -> Bool. Observadora.
@@ -32,10 +35,32 @@
  */
 template <class T>
 class PilaLE {
+private:
+	class Nodo;
+
 public:
 
+	/**
+	 Almacn del que pueden sacar sus nodos varias pilas
+	 (ver PoolNodos.h). Los nodos que se liberan en una de
+	 ellas se reutilizan en cualquiera, y toda la memoria se
+	 devuelve de golpe al destruir el almacn, que debe
+	 vivir ms que las pilas que lo usan. No se puede usar
+	 desde varios hilos a la vez.
+	 */
+	typedef PoolNodos<Nodo> Almacen;
+
 	/** Constructor; operacin PilaVacia */
-	PilaLE() : _cima(NULL), _numElems(0) {
+	PilaLE() : _cima(NULL), _numElems(0), _almacen(NULL) {
+	}
+
+	/**
+	 Constructor; operacin PilaVacia. Los nodos de la pila
+	 saldrn del almacn dado en lugar de pedirse uno a uno
+	 con new.
+	 */
+	explicit PilaLE(Almacen &almacen) : _cima(NULL), _numElems(0),
+			_almacen(&almacen) {
 	}
 
 	/** Destructor; elimina la lista enlazada. */
@@ -50,7 +75,22 @@ public:
 	 @param elem Elemento a apilar.
 	*/
 	void apila(const T &elem) {
-		_cima = new Nodo(elem, _cima);
+		_cima = creaNodo(_cima, elem);
+		_numElems++;
+	}
+
+	/** Igual que el anterior, pero mueve el elemento a la
+	    pila en lugar de copiarlo. */
+	void apila(T &&elem) {
+		_cima = creaNodo(_cima, std::move(elem));
+		_numElems++;
+	}
+
+	/** Apila un elemento construido directamente en su nodo
+	    a partir de "args". */
+	template <class... Args>
+	void emplaza(Args&&... args) {
+		_cima = creaNodo(_cima, std::forward<Args>(args)...);
 		_numElems++;
 	}
 	
@@ -66,7 +106,7 @@ public:
 			throw EPilaVacia();
 		Nodo *aBorrar = _cima;
 		_cima = _cima->_sig;
-		delete aBorrar;
+		destruyeNodo(aBorrar);
 		--_numElems;
 	}
 
@@ -115,10 +155,17 @@ public:
 	// //
 
 	/** Constructor copia */
-	PilaLE(const PilaLE<T> &other) : _cima(NULL) {
+	PilaLE(const PilaLE<T> &other) : _cima(NULL), _almacen(NULL) {
 		copia(other);
 	}
 
+	/** Constructor de movimiento: se queda con los nodos de
+	    other (y con su almacn), y other queda vaca. */
+	PilaLE(PilaLE<T> &&other) : _cima(NULL), _numElems(0),
+			_almacen(other._almacen) {
+		trasladaDe(other);
+	}
+
 	/** Operador de asignacin */
 	PilaLE<T> &operator=(const PilaLE<T> &other) {
 		if (this != &other) {
@@ -128,6 +175,17 @@ public:
 		return *this;
 	}
 
+	/** Asignacin de movimiento. La pila conserva su almacn. */
+	PilaLE<T> &operator=(PilaLE<T> &&other) {
+		if (this != &other) {
+			libera();
+			_cima = NULL;
+			_numElems = 0;
+			trasladaDe(other);
+		}
+		return *this;
+	}
+
 	/** Operador de comparacin. */
 	bool operator==(const PilaLE<T> &rhs) const {
 		if (_numElems != rhs._numElems)
@@ -154,6 +212,29 @@ protected:
 		libera(_cima);
 	}
 
+	/**
+	 Pasa a esta pila, que debe estar vaca, los elementos de
+	 other, que queda vaca. Si las dos usan el mismo almacn
+	 se pasan los nodos tal cual; si no, los elementos se
+	 mueven a nodos nuevos (en el mismo orden).
+	 */
+	void trasladaDe(PilaLE &other) {
+		if (_almacen == other._almacen) {
+			_cima = other._cima;
+			_numElems = other._numElems;
+		} else {
+			Nodo **ult = &_cima;
+			for (Nodo *act = other._cima; act != NULL; act = act->_sig) {
+				*ult = creaNodo((Nodo *) NULL, std::move(act->_elem));
+				ult = &(*ult)->_sig;
+				_numElems++;
+			}
+			other.libera();
+		}
+		other._cima = NULL;
+		other._numElems = 0;
+	}
+
 	void copia(const PilaLE &other) {
 
 		if (other.esVacia()) {
@@ -162,11 +243,11 @@ protected:
 		} else {
 			Nodo *act = other._cima;
 			Nodo *ant;
-			_cima = new Nodo(act->_elem);
+			_cima = creaNodo(act->_elem);
 			ant = _cima;
 			while (act->_sig != NULL) {
 				act = act->_sig;
-				ant->_sig = new Nodo(act->_elem);
+				ant->_sig = creaNodo(act->_elem);
 				ant = ant->_sig;
 			}
 			_numElems = other._numElems;
@@ -187,6 +268,12 @@ private:
 		Nodo(const T &elem, Nodo *sig) : 
 		    _elem(elem), _sig(sig) {}
 
+		// Construye el elemento a partir de "args" directamente
+		// dentro del nodo.
+		template <class... Args>
+		Nodo(Nodo *sig, Args&&... args) :
+		    _elem(std::forward<Args>(args)...), _sig(sig) {}
+
 		T _elem;
 		Nodo *_sig;
 	};
@@ -196,20 +283,46 @@ private:
 	 primer nodo se pasa como parmetro.
 	 Se admite que el nodo sea NULL (no habr nada que
 	 liberar).
+	 Tambin con almacn se recorren los nodos uno a uno:
+	 cada hueco tiene que volver a la lista de libres para
+	 que lo reutilicen las dems pilas, y slo al destruir
+	 el almacn se devuelve la memoria de golpe.
 	 */
-	static void libera(Nodo *prim) {
+	void libera(Nodo *prim) {
 		while (prim != NULL) {
 			Nodo *aux = prim;
 			prim = prim->_sig;
-			delete aux;
+			destruyeNodo(aux);
 		}
 	}
 
+	/**
+	 Crea un nodo con los argumentos dados, en el almacn de
+	 la pila si tiene uno.
+	 */
+	template <class... Args>
+	Nodo *creaNodo(Args&&... args) {
+		if (_almacen != NULL)
+			return _almacen->crea(std::forward<Args>(args)...);
+		return new Nodo(std::forward<Args>(args)...);
+	}
+
+	/** Destruye un nodo creado con creaNodo. */
+	void destruyeNodo(Nodo *n) {
+		if (_almacen != NULL)
+			_almacen->destruye(n);
+		else
+			delete n;
+	}
+
 	/** Puntero al primer elemento */
 	Nodo *_cima;
 
 	/** Nmero de elementos */
 	int _numElems;
+
+	/** Almacn del que salen los nodos (NULL si se usa new). */
+	Almacen *_almacen;
 };
 
 #endif // __PILA_LISTA_ENLAZADA_H
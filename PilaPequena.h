@@ -0,0 +1,242 @@
+/**
+  @file PilaPequena.h
+
+  Implementacin del TAD Pila que guarda los primeros
+  elementos dentro del propio objeto y slo usa memoria
+  dinmica si crece ms.
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __PILA_PEQUENA_H
+#define __PILA_PEQUENA_H
+
+#include "Excepciones.h"
+#include "Traslado.h"
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+/**
+ Implementacin del TAD Pila pensada para pilas pequeas y
+ de vida corta (por ejemplo, las de un evaluador de
+ expresiones). Los N primeros elementos se guardan en un
+ vector que forma parte del objeto, as que una pila que no
+ pasa de N elementos no reserva memoria nunca. Si se llena,
+ los elementos pasan a un vector dinmico que se dobla cada
+ vez que se llena, como en Pila.
+
+ Las operaciones son las de Pila:
+
+ - PilaVacia: -> Pila. Generadora implementada en el
+   constructor sin parmetros.
+ - apila: Pila, Elem -> Pila. Generadora
+   (tambin emplaza, que construye el elemento en la pila)
+ - desapila: Pila - -> Pila. Modificadora parcial.
+ - cima: Pila - -> Elem. Observadora parcial.
+ - esVacia: Pila -> Bool. Observadora.
+ - numElems: Pila -> Entero. Observadora.
+ */
+template <class T, unsigned int N = 16>
+class PilaPequena {
+	static_assert(N > 0, "PilaPequena necesita un vector interno no vacio");
+public:
+
+	/** Constructor; operacin PilaVacia. */
+	PilaPequena() : _v(local()), _tam(N), _numElems(0) {
+	}
+
+	/** Destructor; elimina los elementos y el vector dinmico,
+	    si lo hay. */
+	~PilaPequena() {
+		libera();
+	}
+
+	/**
+	 Apila un elemento. Operacin generadora.
+
+	 @param elem Elemento a apilar.
+	*/
+	void apila(const T &elem) {
+		emplaza(elem);
+	}
+
+	void apila(T &&elem) {
+		emplaza(std::move(elem));
+	}
+
+	/**
+	 Apila un elemento construido directamente en su posicin
+	 a partir de "args".
+	 */
+	template <class... Args>
+	void emplaza(Args&&... args) {
+		if (_numElems == _tam) {
+			// Como en Pila::emplaza, args puede referirse a la cima.
+			T elem(std::forward<Args>(args)...);
+			amplia();
+			new (&_v[_numElems]) T(std::move(elem));
+		} else
+			new (&_v[_numElems]) T(std::forward<Args>(args)...);
+		_numElems++;
+	}
+
+	/**
+	 Desapila un elemento. Operacin modificadora parcial,
+	 que falla si la pila est vaca.
+	*/
+	void desapila() {
+		if (esVacia())
+			throw EPilaVacia();
+		--_numElems;
+		_v[_numElems].~T();
+	}
+
+	/**
+	 Devuelve el elemento en la cima de la pila. Operacin
+	 observadora parcial, que falla si la pila est vaca.
+
+	 @return Elemento en la cima de la pila.
+	 */
+	const T &cima() const {
+		if (esVacia())
+			throw EPilaVacia();
+		return _v[_numElems - 1];
+	}
+
+	/** @return true si la pila no tiene ningn elemento. */
+	bool esVacia() const {
+		return _numElems == 0;
+	}
+
+	/** @return Nmero de elementos. */
+	int numElems() const {
+		return _numElems;
+	}
+
+	// //
+	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL
+	// A LA CLASE
+	// //
+
+	/** Constructor copia */
+	PilaPequena(const PilaPequena<T, N> &other) :
+			_v(local()), _tam(N), _numElems(0) {
+		copia(other);
+	}
+
+	/** Constructor de movimiento. Si other usa memoria dinmica
+	    se queda con su vector; si no, mueve los elementos uno
+	    a uno. other queda vaca. */
+	PilaPequena(PilaPequena<T, N> &&other) :
+			_v(local()), _tam(N), _numElems(0) {
+		trasladaDe(other);
+	}
+
+	/** Operador de asignacin */
+	PilaPequena<T, N> &operator=(const PilaPequena<T, N> &other) {
+		if (this != &other) {
+			libera();
+			copia(other);
+		}
+		return *this;
+	}
+
+	/** Asignacin de movimiento */
+	PilaPequena<T, N> &operator=(PilaPequena<T, N> &&other) {
+		if (this != &other) {
+			libera();
+			trasladaDe(other);
+		}
+		return *this;
+	}
+
+	/** Operador de comparacin. */
+	bool operator==(const PilaPequena<T, N> &rhs) const {
+		if (_numElems != rhs._numElems)
+			return false;
+		for (unsigned int i = 0; i < _numElems; ++i)
+			if (_v[i] != rhs._v[i])
+				return false;
+		return true;
+	}
+
+	bool operator!=(const PilaPequena<T, N> &rhs) const {
+		return !(*this == rhs);
+	}
+
+protected:
+
+	/** Destruye los elementos y vuelve al vector interno. */
+	void libera() {
+		for (unsigned int i = 0; i < _numElems; ++i)
+			_v[i].~T();
+		if (_v != local())
+			free(_v);
+		_v = local();
+		_tam = N;
+		_numElems = 0;
+	}
+
+	/** Copia los elementos de other en esta pila, que debe
+	    estar vaca y usando el vector interno. */
+	void copia(const PilaPequena<T, N> &other) {
+		if (other._numElems > N)
+			redimensiona(other._numElems);
+		for (; _numElems < other._numElems; ++_numElems)
+			new (&_v[_numElems]) T(other._v[_numElems]);
+	}
+
+	/** Pasa a esta pila (vaca y usando el vector interno) los
+	    elementos de other, que queda vaca. */
+	void trasladaDe(PilaPequena<T, N> &other) {
+		if (other._v != other.local()) {
+			_v = other._v;
+			_tam = other._tam;
+			other._v = other.local();
+			other._tam = N;
+		} else
+			trasladaElems(_v, other._v, other._numElems);
+		_numElems = other._numElems;
+		other._numElems = 0;
+	}
+
+	/** Dobla el tamao del vector. */
+	void amplia() {
+		redimensiona(2 * _tam);
+	}
+
+	/** Pasa los elementos a un vector dinmico de tamao tam. */
+	void redimensiona(unsigned int tam) {
+		T *nuevo = static_cast<T *>(malloc(tam * sizeof(T)));
+		if (nuevo == NULL)
+			throw std::bad_alloc();
+		trasladaElems(nuevo, _v, _numElems);
+		if (_v != local())
+			free(_v);
+		_v = nuevo;
+		_tam = tam;
+	}
+
+private:
+
+	/** Direccin del vector interno. */
+	T *local() {
+		return reinterpret_cast<T *>(_local);
+	}
+
+	/** Vector en uso: _local o uno dinmico. */
+	T *_v;
+
+	/** Tamao del vector _v. */
+	unsigned int _tam;
+
+	/** Nmero de elementos guardados. */
+	unsigned int _numElems;
+
+	/** Vector interno para los N primeros elementos. */
+	typename std::aligned_storage<sizeof(T), alignof(T)>::type _local[N];
+};
+
+#endif // __PILA_PEQUENA_H
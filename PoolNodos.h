@@ -0,0 +1,211 @@
+/**
+ @file PoolNodos.h
+
+ Reserva de memoria por bloques para los nodos de las estructuras
+ enlazadas.
+
+ Estructura de Datos y Algoritmos
+ Facultad de Informtica
+ Universidad Complutense de Madrid
+ */
+#ifndef __POOL_NODOS_H
+#define __POOL_NODOS_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ Almacn de nodos de tipo T. En lugar de pedir cada nodo al sistema con
+ new, los nodos se sacan de bloques contiguos que se reservan de una vez.
+ Los nodos que se destruyen quedan en una lista de huecos libres y se
+ reutilizan en las siguientes peticiones, y toda la memoria se devuelve al
+ sistema de golpe al vaciar o destruir el almacn.
+
+ Los bloques empiezan siendo pequeos y van doblando su tamao hasta
+ MAX_NODOS_BLOQUE, para no desperdiciar memoria en estructuras con pocos
+ elementos.
+
+ Las operaciones son:
+
+ - crea: construye un nodo con los argumentos dados y lo devuelve.
+ - destruye: destruye un nodo y deja su hueco libre.
+ - vacia: devuelve todos los bloques al sistema. No llama a los
+   destructores de los nodos que sigan vivos.
+ */
+template <class T>
+class PoolNodos {
+public:
+
+	/** Nmero de nodos del primer bloque. */
+	enum { NODOS_PRIMER_BLOQUE = 8 };
+
+	/** Nmero mximo de nodos de cada bloque. */
+	enum { MAX_NODOS_BLOQUE = 1024 };
+
+	/** Constructor; almacn vaco (todava sin bloques). */
+	PoolNodos() : _bloques(NULL), _libres(NULL), _sigHueco(NULL),
+			_finBloque(NULL), _nodosBloque(NODOS_PRIMER_BLOQUE),
+			_numBloques(0), _numHuecos(0) {
+	}
+
+	/** Destructor; devuelve todos los bloques al sistema. */
+	~PoolNodos() {
+		vacia();
+	}
+
+	/**
+	 Construye un nodo dentro del almacn.
+
+	 @param args argumentos para el constructor de T.
+	 @return puntero al nodo creado.
+	 */
+	template <class... Args>
+	T *crea(Args&&... args) {
+		void *hueco = reservaHueco();
+		try {
+			return new (hueco) T(std::forward<Args>(args)...);
+		} catch (...) {
+			devuelveHueco(hueco);
+			throw;
+		}
+	}
+
+	/**
+	 Destruye un nodo creado con crea y deja su hueco libre para
+	 reutilizarlo.
+
+	 @param nodo nodo a destruir (se admite NULL).
+	 */
+	void destruye(T *nodo) {
+		if (nodo == NULL)
+			return;
+		nodo->~T();
+		devuelveHueco(nodo);
+	}
+
+	/**
+	 Devuelve al sistema todos los bloques reservados. Los nodos que
+	 estuvieran vivos dejan de ser vlidos sin que se llame a sus
+	 destructores, as que el dueo de los nodos debe haberlos destruido
+	 antes si T no es trivialmente destructible.
+	 */
+	void vacia() {
+		while (_bloques != NULL) {
+			Bloque *aux = _bloques;
+			_bloques = _bloques->_sig;
+			delete[] aux->_huecos;
+			delete aux;
+		}
+		_libres = NULL;
+		_sigHueco = _finBloque = NULL;
+		_nodosBloque = NODOS_PRIMER_BLOQUE;
+		_numBloques = 0;
+		_numHuecos = 0;
+	}
+
+	/**
+	 @return nmero de bloques reservados.
+	 */
+	unsigned int numBloques() const {
+		return _numBloques;
+	}
+
+	/**
+	 @return nmero total de huecos (libres u ocupados) en los bloques.
+	 */
+	unsigned int numHuecos() const {
+		return _numHuecos;
+	}
+
+	/**
+	 @return bytes reservados en los bloques (sin contar este objeto).
+	 */
+	size_t bytes() const {
+		return _numHuecos * sizeof(Hueco) + _numBloques * sizeof(Bloque);
+	}
+
+	// Un almacn es dueo de su memoria, as que no se puede copiar.
+	PoolNodos(const PoolNodos &) = delete;
+	PoolNodos &operator=(const PoolNodos &) = delete;
+
+private:
+
+	/**
+	 Hueco para un nodo. Mientras est libre guarda el puntero al
+	 siguiente hueco libre.
+	 */
+	union Hueco {
+		Hueco *_sig;
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type _datos;
+	};
+
+	/** Bloque de huecos contiguos; los bloques forman una lista. */
+	struct Bloque {
+		Hueco *_huecos;
+		Bloque *_sig;
+	};
+
+	/**
+	 Devuelve un hueco sin construir: primero se reutilizan los huecos
+	 libres, despus los que quedan sin usar en el ltimo bloque y, si no
+	 queda ninguno, se reserva un bloque nuevo.
+	 */
+	void *reservaHueco() {
+		if (_libres != NULL) {
+			Hueco *h = _libres;
+			_libres = _libres->_sig;
+			return h;
+		}
+		if (_sigHueco == _finBloque)
+			nuevoBloque();
+		return _sigHueco++;
+	}
+
+	/** Aade un hueco a la lista de huecos libres. */
+	void devuelveHueco(void *p) {
+		Hueco *h = static_cast<Hueco *>(p);
+		h->_sig = _libres;
+		_libres = h;
+	}
+
+	/** Reserva un bloque nuevo y dobla el tamao del siguiente. */
+	void nuevoBloque() {
+		Bloque *b = new Bloque;
+		b->_huecos = new Hueco[_nodosBloque];
+		b->_sig = _bloques;
+		_bloques = b;
+
+		_sigHueco = b->_huecos;
+		_finBloque = b->_huecos + _nodosBloque;
+		_numBloques++;
+		_numHuecos += _nodosBloque;
+
+		if (_nodosBloque < MAX_NODOS_BLOQUE)
+			_nodosBloque *= 2;
+	}
+
+	/** Lista de bloques reservados. */
+	Bloque *_bloques;
+
+	/** Lista de huecos libres (de nodos destruidos). */
+	Hueco *_libres;
+
+	/** Primer hueco an sin usar del ltimo bloque. */
+	Hueco *_sigHueco;
+
+	/** Fin del ltimo bloque. */
+	Hueco *_finBloque;
+
+	/** Nmero de nodos del prximo bloque. */
+	unsigned int _nodosBloque;
+
+	/** Nmero de bloques reservados. */
+	unsigned int _numBloques;
+
+	/** Nmero total de huecos en los bloques. */
+	unsigned int _numHuecos;
+};
+
+#endif // __POOL_NODOS_H
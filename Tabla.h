@@ -14,8 +14,15 @@
 
 #include "Excepciones.h"
 #include "Hash.h"
+#include "PoolNodos.h"
 
 #include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 
 
@@ -46,42 +53,119 @@
  */
 template <class C, class V>
 class Tabla {
+public:
+
+	/**
+	 * Par (clave, valor) guardado en la tabla. Es lo que devuelve *it al
+	 * recorrerla con un Iterador: una referencia al par dentro de su
+	 * nodo, que sigue siendo vlida aunque el iterador avance.
+	 */
+	class Par {
+	public:
+		/* Constructores. */
+		Par(const C &clave, const V &valor) : _clave(clave), _valor(valor) {};
+
+		// Construye la clave a partir de "clave" y el valor a partir de
+		// "args" directamente dentro del par.
+		template <class K, class... Args>
+		Par(std::piecewise_construct_t, K &&clave, Args&&... args) :
+				_clave(std::forward<K>(clave)),
+				_valor(std::forward<Args>(args)...) {};
+
+		const C& clave() const { return _clave; }
+		const V& valor() const { return _valor; }
+
+		/* Atributos pblicos. */
+		C _clave;
+		V _valor;
+	};
+
 private:
 	
 	/**
-	 * La tabla contiene un array de punteros a nodos. Cada nodo contiene una 
-	 * clave, un valor y un puntero al siguiente nodo.
+	 * La tabla contiene un array de punteros a nodos. Cada nodo contiene un
+	 * par (clave, valor) y un puntero al siguiente nodo. Los nodos se crean
+	 * en el almacn _pool de la tabla, que los agrupa en bloques contiguos.
 	 */
-	class Nodo {
+	class Nodo : public Par {
 	public:
 		/* Constructores. */
 		Nodo(const C &clave, const V &valor) : 
-				_clave(clave), _valor(valor), _sig(NULL) {};
+				Par(clave, valor), _sig(NULL) {};
 		
 		Nodo(const C &clave, const V &valor, Nodo *sig) : 
-				_clave(clave), _valor(valor), _sig(sig) {};
+				Par(clave, valor), _sig(sig) {};
+
+		// Construye la clave a partir de "clave" y el valor a partir de
+		// "args" directamente dentro del nodo.
+		template <class K, class... Args>
+		Nodo(Nodo *sig, K &&clave, Args&&... args) :
+				Par(std::piecewise_construct, std::forward<K>(clave),
+						std::forward<Args>(args)...), _sig(sig) {};
 		
 		/* Atributos pblicos. */
-		C _clave;    
-		V _valor;   
 		Nodo *_sig;  // Puntero al siguiente nodo.
 	};
+
+	/**
+	 * Tipo R, pero slo si K es un tipo de clave compatible con C. Limita
+	 * las versiones de las operaciones que buscan por una clave de otro
+	 * tipo (por ejemplo, const char* en una tabla de std::string) a los
+	 * tipos para los que ClaveCompatible lo permite.
+	 */
+	template <class K, class R>
+	using SiCompatible = typename std::enable_if<
+		ClaveCompatible<C, typename std::decay<K>::type>::valor, R>::type;
 	
 public:
 	
 	/**
-	 * Tamao inicial de la tabla.
+	 * Tamao inicial de la tabla. El tamao es siempre una potencia de
+	 * dos para poder calcular las posiciones con una mscara.
 	 */
-	static const int TAM_INICIAL = 10;
+	static const int TAM_INICIAL = 16;
+
+	/**
+	 * Ocupacin mxima por defecto, en tanto por ciento, antes de ampliar
+	 * la tabla.
+	 */
+	static const unsigned int MAX_OCUPACION = 80;
+
+	/**
+	 * Tamao mximo de la tabla (2^31, la mayor potencia de dos que cabe
+	 * en un unsigned int). A partir de l la tabla ya no se ampla y las
+	 * listas de colisiones simplemente se alargan.
+	 */
+	static const unsigned int TAM_MAXIMO = 1u << 31;
 	
 	/**
 	 * Constructor por defecto. Crea una tabla con TAM_INICIAL
 	 * posiciones.
 	 */
-	Tabla() : _v(new Nodo*[TAM_INICIAL]), _tam(TAM_INICIAL), _numElems(0) {
-		for (unsigned int i=0; i<_tam; ++i) {
-			_v[i] = NULL;
-		}
+	Tabla() : _v(nuevoArray(TAM_INICIAL)), _tam(TAM_INICIAL), _numElems(0),
+			_maxOcupacion(MAX_OCUPACION), _vAnt(NULL), _tamAnt(0),
+			_migrados(0), _incremental(false), _numAmpliaciones(0) {
+	}
+
+	/**
+	 * Crea una tabla con espacio para numElems elementos, de modo que no
+	 * se ampla hasta superarlos.
+	 *
+	 * @param numElems nmero de elementos que se espera guardar.
+	 * @param maxOcupacion ocupacin mxima (elementos por cada 100
+	 *        posiciones) antes de ampliar la tabla, entre 1 y 100.
+	 * @throws IllegalArgumentException si maxOcupacion no est entre 1
+	 *         y 100.
+	 */
+	explicit Tabla(unsigned int numElems,
+			unsigned int maxOcupacion = MAX_OCUPACION) :
+			_v(NULL), _tam(0), _numElems(0), _maxOcupacion(maxOcupacion),
+			_vAnt(NULL), _tamAnt(0), _migrados(0), _incremental(false),
+			_numAmpliaciones(0) {
+		if (maxOcupacion == 0 || maxOcupacion > 100)
+			throw IllegalArgumentException("Ocupacion maxima fuera de (0, 100]");
+		_tam = tamPara(numElems);
+		_v = nuevoArray(_tam);
 	}
 	
 	/**
@@ -99,27 +183,91 @@ public:
 	 * @param valor valor del nuevo elemento.
 	 */
 	void inserta(const C &clave, const V &valor) {
-		
-		// Si la ocupacin es muy alta ampliamos la tabla
-		float ocupacion = 100 * ((float) _numElems) / _tam; 
-		if (ocupacion > MAX_OCUPACION)
-			amplia();
-		
-		// Obtenemos el ndice asociado a la clave.
-		unsigned int ind = ::hash(clave) % _tam;
-		
-		// Si la clave ya exista, actualizamos su valor
-		Nodo *nodo = buscaNodo(clave, _v[ind]);
-		if (nodo != NULL) {
-			nodo->_valor = valor;
-		} else {
-			
-			// Si la clave no exista, creamos un nuevo nodo y lo insertamos
-			// al principio
-			_v[ind] = new Nodo(clave, valor, _v[ind]);
-			_numElems++;
+		insertaAux(clave, valor);
+	}
+
+	/**
+	 * Igual que la anterior, pero mueve la clave y el valor al nodo en
+	 * lugar de copiarlos.
+	 *
+	 * @param clave clave del nuevo elemento.
+	 * @param valor valor del nuevo elemento.
+	 */
+	void inserta(C &&clave, V &&valor) {
+		insertaAux(std::move(clave), std::move(valor));
+	}
+
+	/**
+	 * Inserta la clave dada construyendo su valor directamente en la tabla
+	 * a partir de los argumentos "args" (equivalente a try_emplace de la
+	 * STL). Si la clave ya exista la tabla no se modifica y el valor no
+	 * llega a construirse.
+	 *
+	 * @param clave clave del nuevo elemento.
+	 * @param args argumentos para el constructor del valor.
+	 * @return true si se ha insertado el elemento; false si la clave ya
+	 *         estaba en la tabla.
+	 */
+	template <class... Args>
+	bool emplaza(const C &clave, Args&&... args) {
+		return emplazaAux(clave, std::forward<Args>(args)...);
+	}
+
+	template <class... Args>
+	bool emplaza(C &&clave, Args&&... args) {
+		return emplazaAux(std::move(clave), std::forward<Args>(args)...);
+	}
+
+	/**
+	 * Versin de emplaza para claves de un tipo compatible con C (ver
+	 * ClaveCompatible en Hash.h). La clave de tipo C slo se construye si
+	 * hay que insertarla.
+	 */
+	template <class K, class... Args>
+	SiCompatible<K, bool> emplaza(const K &clave, Args&&... args) {
+		return emplazaAux(clave, std::forward<Args>(args)...);
+	}
+
+	/**
+	 * Inserta todos los pares del intervalo [ini, fin), que deben tener
+	 * los campos first (clave) y second (valor), como std::pair. Antes de
+	 * empezar se reserva espacio para todos, as que la tabla se ampla a
+	 * lo sumo una vez y cada par se coloca directamente en su posicin
+	 * sin volver a comprobar la ocupacin. Si una clave se repite, se
+	 * queda el ltimo valor.
+	 *
+	 * @param ini iterador (o puntero) al primer par.
+	 * @param fin iterador (o puntero) al final del intervalo.
+	 */
+	template <class It>
+	void insertaTodos(It ini, It fin) {
+		reserva(_numElems + (unsigned int) std::distance(ini, fin));
+
+		for (; ini != fin; ++ini) {
+			Nodo **cubo = cuboDe(ini->first);
+			Nodo *nodo = buscaNodo(ini->first, *cubo);
+			if (nodo != NULL) {
+				nodo->_valor = ini->second;
+			} else {
+				*cubo = _pool.crea(*cubo, ini->first, ini->second);
+				_numElems++;
+			}
 		}
 	}
+
+	/**
+	 * Prepara la tabla para guardar al menos numElems elementos sin
+	 * ampliarse. Si hace falta, los nodos se reparten de una vez en un
+	 * array del tamao final (aunque est activa la ampliacin
+	 * incremental). Nunca reduce la tabla.
+	 *
+	 * @param numElems nmero de elementos que se espera guardar.
+	 */
+	void reserva(unsigned int numElems) {
+		unsigned int tam = tamPara(numElems);
+		if (tam > _tam)
+			redimensiona(tam, false);
+	}
 	
 	/**
 	 * Elimina el elemento de la tabla con la clave dada. Si no exista ningn
@@ -128,28 +276,12 @@ public:
 	 * @param clave clave del elemento a eliminar.
 	 */
 	void borra(const C &clave) {
-		
-		// Obtenemos el ndice asociado a la clave.
-		unsigned int ind = ::hash(clave) % _tam;
-		
-		// Buscamos el nodo que contiene esa clave y el nodo anterior.
-		Nodo *act = _v[ind];
-		Nodo *ant = NULL;
-		buscaNodo(clave, act, ant);
-		
-		if (act != NULL) {
-			
-			// Sacamos el nodo de la secuencia de nodos.
-			if (ant != NULL) {
-				ant->_sig = act->_sig;
-			} else {
-				_v[ind] = act->_sig;
-			}
-			
-			// Borramos el nodo extrado.
-			delete act;
-			_numElems--;
-		}
+		borraAux(clave);
+	}
+
+	template <class K>
+	SiCompatible<K, void> borra(const K &clave) {
+		borraAux(clave);
 	}
 	
 	/**
@@ -158,13 +290,13 @@ public:
 	 * @param clave clave a buscar.
 	 * @return si existe algn elemento con esa clave.
 	 */
-	bool esta(const C &clave) {
-		// Obtenemos el ndice asociado a la clave.
-		unsigned int ind = ::hash(clave) % _tam;
-		
-		// Buscamos un nodo que contenga esa clave.
-		Nodo *nodo = buscaNodo(clave, _v[ind]);
-		return nodo != NULL;
+	bool esta(const C &clave) const {
+		return buscaNodo(clave) != NULL;
+	}
+
+	template <class K>
+	SiCompatible<K, bool> esta(const K &clave) const {
+		return buscaNodo(clave) != NULL;
 	}
 	
 	/**
@@ -175,17 +307,41 @@ public:
 	 * @return valor asociado a dicha clave.
 	 * @throw EClaveInexistente si la clave no existe en la tabla.
 	 */
-	const V &consulta(const C &clave) {
-		
-		// Obtenemos el ndice asociado a la clave.
-		unsigned int ind = ::hash(clave) % _tam;
-		
-		// Buscamos un nodo que contenga esa clave.
-		Nodo *nodo = buscaNodo(clave, _v[ind]);
-		if (nodo == NULL)
-			throw EClaveErronea();
-		
-		return nodo->_valor;
+	const V &consulta(const C &clave) const {
+		return consultaAux(clave);
+	}
+
+	template <class K>
+	SiCompatible<K, const V &> consulta(const K &clave) const {
+		return consultaAux(clave);
+	}
+
+	/**
+	 * Devuelve un puntero al valor asociado a la clave dada, o NULL si la
+	 * tabla no contiene esa clave. A diferencia de consulta no lanza
+	 * ninguna excepcin, por lo que es preferible cuando se espera que
+	 * muchas bsquedas fallen. El puntero sigue siendo vlido hasta que
+	 * se borra ese elemento (ampliar la tabla no mueve los nodos).
+	 *
+	 * @param clave clave del elemento a buscar.
+	 * @return puntero al valor asociado a la clave o NULL.
+	 */
+	const V *busca(const C &clave) const {
+		return buscaAux(clave);
+	}
+
+	V *busca(const C &clave) {
+		return buscaAux(clave);
+	}
+
+	template <class K>
+	SiCompatible<K, const V *> busca(const K &clave) const {
+		return buscaAux(clave);
+	}
+
+	template <class K>
+	SiCompatible<K, V *> busca(const K &clave) {
+		return buscaAux(clave);
 	}
 
 	/**
@@ -196,26 +352,111 @@ public:
 	bool esVacia() const {
 		return _numElems == 0;
 	}
+
+	/**
+	 * @return nmero de elementos de la tabla.
+	 */
+	unsigned int numElems() const {
+		return _numElems;
+	}
+
+	/**
+	 * Nmero de longitudes distintas que distingue el histograma de
+	 * Estadisticas; las listas ms largas se cuentan en la ltima.
+	 */
+	static const unsigned int TAM_HISTOGRAMA = 16;
+
+	/**
+	 * Datos sobre el estado interno de la tabla, para detectar funciones
+	 * hash que reparten mal las claves (listas largas y muchas posiciones
+	 * vacas) o tablas que ocupan ms memoria de la necesaria.
+	 */
+	struct Estadisticas {
+		/** Nmero de elementos. */
+		unsigned int numElems;
+		/** Posiciones del array (de los dos si hay una ampliacin en curso). */
+		unsigned int numPosiciones;
+		/** Longitud de la lista ms larga. */
+		unsigned int listaMasLarga;
+		/** Nodos que se comparan, de media, al buscar una clave que est. */
+		double longitudMedia;
+		/** Memoria ocupada por la tabla, incluidos sus nodos. */
+		size_t bytes;
+		/** Veces que se ha ampliado el array. */
+		unsigned int numAmpliaciones;
+		/** histograma[i]: posiciones cuya lista tiene i nodos (la ltima
+		    cuenta las de TAM_HISTOGRAMA - 1 nodos o ms). */
+		unsigned int histograma[TAM_HISTOGRAMA];
+	};
+
+	/**
+	 * Calcula las estadsticas de la tabla. Recorre todas las posiciones,
+	 * as que su coste es lineal.
+	 *
+	 * @return estadsticas de la tabla.
+	 */
+	Estadisticas estadisticas() const {
+		Estadisticas e;
+		e.numElems = _numElems;
+		e.numPosiciones = numCubos();
+		e.listaMasLarga = 0;
+		e.numAmpliaciones = _numAmpliaciones;
+		for (unsigned int i=0; i<TAM_HISTOGRAMA; ++i)
+			e.histograma[i] = 0;
+
+		// Encontrar la clave del k-simo nodo de una lista cuesta k
+		// comparaciones, as que una lista de n nodos suma n(n+1)/2.
+		unsigned long long comparaciones = 0;
+		for (unsigned int i=0; i<numCubos(); ++i) {
+			unsigned int n = 0;
+			for (Nodo *act = cubo(i); act != NULL; act = act->_sig)
+				n++;
+			comparaciones += (unsigned long long) n * (n + 1) / 2;
+			if (n > e.listaMasLarga)
+				e.listaMasLarga = n;
+			e.histograma[(n < TAM_HISTOGRAMA) ? n : TAM_HISTOGRAMA - 1]++;
+		}
+		e.longitudMedia = (_numElems == 0) ? 0.0 :
+				(double) comparaciones / _numElems;
+
+		e.bytes = sizeof(*this) + numCubos() * sizeof(Nodo*) + _pool.bytes();
+		return e;
+	}
+
+	/**
+	 * Activa o desactiva la ampliacin incremental. Por defecto, cuando la
+	 * tabla se llena se reparten todos sus nodos en un array el doble de
+	 * grande durante una nica insercin, que tarda tanto ms cuanto mayor
+	 * es la tabla. Con la ampliacin incremental el array antiguo se
+	 * conserva y cada operacin modificadora traslada como mucho
+	 * CUBOS_POR_PASO de sus posiciones al nuevo, de modo que ninguna
+	 * operacin paga el coste completo de la ampliacin. Mientras tanto
+	 * las bsquedas miran en el array antiguo si la posicin de la clave
+	 * an no se ha trasladado, y en el nuevo si ya se ha hecho.
+	 *
+	 * @param activa si se quiere usar la ampliacin incremental.
+	 */
+	void ponAmpliacionIncremental(bool activa) {
+		_incremental = activa;
+		if (!activa)
+			trasladaCubos(_tamAnt);
+	}
 	
 	/**
 	 * Clase interna que implementa un iterador sobre el conjunto de pares
 	 * (clave, valor). Es importante tener en cuenta que el iterador puede
-	 * devolver el conunto de pares en cualquier orden.
+	 * devolver el conunto de pares en cualquier orden. Se puede usar tambin
+	 * como iterador de la STL (con begin y end, por ejemplo en un for de
+	 * rango): *it es el Par del nodo actual, con clave() y valor().
 	 */
 	class Iterador {
 	public:
+		/** Iterador que no recorre ninguna tabla. */
+		Iterador() : _act(NULL), _ind(0), _tabla(NULL) { }
+
 		void avanza() {
 			if (_act == NULL) throw EAccesoInvalido();
-			
-			// Buscamos el siguiente nodo de la lista de nodos.
-			_act = _act->_sig;
-			
-			// Si hemos llegado al final de la lista de nodos, seguimos
-			// buscando por el vector _v.
-			while ((_act == NULL) && (_ind < _tabla->_tam - 1)) {
-				++_ind;
-				_act = _tabla->_v[_ind];
-			}
+			operator++();
 		}
 		
 		const C& clave() const {
@@ -235,6 +476,47 @@ public:
 		bool operator!=(const Iterador &other) const {
 			return !(this->operator==(other));
 		}
+
+		// Operadores de iterador de avance de la STL. *it devuelve una
+		// referencia al Par del nodo, as que no se copia y sigue siendo
+		// vlida al avanzar. operator++ slo comprueba con assert que no
+		// estemos en el final.
+		typedef std::forward_iterator_tag iterator_category;
+		typedef Par value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const Par *pointer;
+		typedef const Par &reference;
+
+		const Par &operator*() const {
+			assert(_act != NULL);
+			return *_act;
+		}
+
+		const Par *operator->() const {
+			assert(_act != NULL);
+			return _act;
+		}
+
+		Iterador &operator++() {
+			assert(_act != NULL);
+			
+			// Buscamos el siguiente nodo de la lista de nodos.
+			_act = _act->_sig;
+			
+			// Si hemos llegado al final de la lista de nodos, seguimos
+			// buscando por el vector _v (y por _vAnt si no est vaco).
+			while ((_act == NULL) && (_ind < _tabla->numCubos() - 1)) {
+				++_ind;
+				_act = _tabla->cubo(_ind);
+			}
+			return *this;
+		}
+
+		Iterador operator++(int) {
+			Iterador ret(*this);
+			operator++();
+			return ret;
+		}
 		
 	private:
 		// Para que pueda construir objetos del tipo iterador
@@ -245,7 +527,7 @@ public:
 
 		
 		Nodo* _act;				///< Puntero al nodo actual del recorrido
-		unsigned int _ind;		///< ndice actual en el vector _v
+		unsigned int _ind;		///< ndice actual (ver Tabla::cubo)
 		const Tabla *_tabla;	///< Tabla que se est recorriendo
 		
 	};
@@ -255,14 +537,14 @@ public:
 	 * El iterador devuelto coincidir con final() si la tabla est vaca.
 	 * @return iterador al primer par (clave, valor) de la tabla.
 	 */
-	Iterador principio() {
+	Iterador principio() const {
 		
 		unsigned int ind = 0;
-		Nodo* act = _v[ind];
+		Nodo* act = cubo(ind);
 		
-		while ((act == NULL) && (ind < _tam - 1)) {
+		while ((act == NULL) && (ind < numCubos() - 1)) {
 			++ind;
-			act = _v[ind];
+			act = cubo(ind);
 		}
 		
 		return Iterador(this, act, ind);
@@ -276,6 +558,15 @@ public:
 	Iterador final() const {
 		return Iterador(this, NULL, _tam);
 	}
+
+	/** Equivalentes a principio() y final() con los nombres de la STL. */
+	Iterador begin() const {
+		return principio();
+	}
+
+	Iterador end() const {
+		return final();
+	}
 	
 	
 	// 
@@ -316,29 +607,38 @@ private:
 	 */
 	void libera() {
 		
-		// Liberamos las listas de nodos.
-		for (unsigned int i=0; i<_tam; i++) {
-			liberaNodos(_v[i]);
+		// Destruimos los nodos (si hace falta) y devolvemos de golpe todos
+		// los bloques del almacn.
+		for (unsigned int i=0; i<numCubos(); i++) {
+			destruyeNodos(cubo(i));
 		}
+		_pool.vacia();
 		
 		// Liberamos el array de punteros a nodos.
-		if (_v != NULL) {
-			delete[] _v;
-			_v = NULL;
-		}
+		liberaArray(_v);
+		_v = NULL;
+		liberaArray(_vAnt);
+		_vAnt = NULL;
+		_tamAnt = 0;
+		_migrados = 0;
 	}
 	
 	/**
-	 * Libera un nodo y todos los siguientes.
+	 * Llama al destructor de un nodo y de todos los siguientes, sin
+	 * devolver sus huecos al almacn (se liberan despus todos juntos).
+	 * Si ni las claves ni los valores necesitan destructor no se recorre
+	 * la lista.
 	 *
-	 * @param prim puntero al primer nodo de la lista a liberar.
+	 * @param prim puntero al primer nodo de la lista a destruir.
 	 */
-	static void liberaNodos(Nodo *prim) {
+	static void destruyeNodos(Nodo *prim) {
+		if (std::is_trivially_destructible<Nodo>::value)
+			return;
 		
 		while (prim != NULL) {
 			Nodo *aux = prim;
 			prim = prim->_sig;
-			delete aux;
+			aux->~Nodo();
 		}		
 	}	
 
@@ -351,35 +651,206 @@ private:
 	void copia(const Tabla<C,V> &other) {
 		_tam = other._tam;
 		_numElems = other._numElems;
+		_maxOcupacion = other._maxOcupacion;
+		_vAnt = NULL;
+		_tamAnt = 0;
+		_migrados = 0;
+		_incremental = other._incremental;
+		_numAmpliaciones = other._numAmpliaciones;
 	
 		// Reservar memoria para el array de punteros a nodos.
-		_v = new Nodo*[_tam];
+		_v = nuevoArray(_tam);
 		for (unsigned int i=0; i<_tam; ++i) { 
-			_v[i] = NULL;
 			
 			// Copiar la lista de nodos de other._v[i] a _v[i].
 			// La lista de nodos queda invertida con respecto a la original.
 			Nodo *act = other._v[i];
 			while (act != NULL) {
-				_v[i] = new Nodo(act->_clave, act->_valor, _v[i]); 
+				_v[i] = _pool.crea(act->_clave, act->_valor, _v[i]); 
+				act = act->_sig;
+			}
+		}
+
+		// Si other estaba a mitad de una ampliacin incremental, los nodos
+		// que le quedan en el array antiguo se colocan ya en su posicin
+		// del nuevo.
+		for (unsigned int i=other._migrados; i<other._tamAnt; ++i) {
+			Nodo *act = other._vAnt[i];
+			while (act != NULL) {
+				unsigned int ind = indice(act->_clave);
+				_v[ind] = _pool.crea(act->_clave, act->_valor, _v[ind]);
 				act = act->_sig;
 			}
 		}
 	}
 	
+	/**
+	 * Implementacin de las dos versiones de inserta.
+	 */
+	template <class K, class W>
+	void insertaAux(K &&clave, W &&valor) {
+
+		// Si hay una ampliacin incremental en curso, avanzamos un paso.
+		trasladaCubos(CUBOS_POR_PASO);
+		
+		// Si la ocupacin es muy alta ampliamos la tabla
+		if (llena())
+			amplia();
+		
+		// Obtenemos la posicin asociada a la clave.
+		Nodo **cubo = cuboDe(clave);
+		
+		// Si la clave ya exista, actualizamos su valor
+		Nodo *nodo = buscaNodo(clave, *cubo);
+		if (nodo != NULL) {
+			nodo->_valor = std::forward<W>(valor);
+		} else {
+			
+			// Si la clave no exista, creamos un nuevo nodo y lo insertamos
+			// al principio
+			*cubo = _pool.crea(*cubo, std::forward<K>(clave),
+					std::forward<W>(valor));
+			_numElems++;
+		}
+	}
+
+	/**
+	 * Implementacin de emplaza. La clave puede ser de tipo C o de un
+	 * tipo compatible; en ambos casos el nodo se crea slo si la clave no
+	 * estaba.
+	 */
+	template <class K, class... Args>
+	bool emplazaAux(K &&clave, Args&&... args) {
+
+		if (buscaNodo(clave) != NULL)
+			return false;
+
+		trasladaCubos(CUBOS_POR_PASO);
+
+		if (llena())
+			amplia();
+
+		Nodo **cubo = cuboDe(clave);
+		*cubo = _pool.crea(*cubo, std::forward<K>(clave),
+				std::forward<Args>(args)...);
+		_numElems++;
+		return true;
+	}
+
+	/**
+	 * Implementacin de borra para claves de tipo C o compatibles.
+	 */
+	template <class K>
+	void borraAux(const K &clave) {
+
+		// Si hay una ampliacin incremental en curso, avanzamos un paso.
+		trasladaCubos(CUBOS_POR_PASO);
+		
+		// Obtenemos la posicin asociada a la clave.
+		Nodo **cubo = cuboDe(clave);
+		
+		// Buscamos el nodo que contiene esa clave y el nodo anterior.
+		Nodo *act = *cubo;
+		Nodo *ant = NULL;
+		buscaNodo(clave, act, ant);
+		
+		if (act != NULL) {
+			
+			// Sacamos el nodo de la secuencia de nodos.
+			if (ant != NULL) {
+				ant->_sig = act->_sig;
+			} else {
+				*cubo = act->_sig;
+			}
+			
+			// Borramos el nodo extrado.
+			_pool.destruye(act);
+			_numElems--;
+		}
+	}
+
+	/**
+	 * Implementacin de consulta para claves de tipo C o compatibles.
+	 */
+	template <class K>
+	const V &consultaAux(const K &clave) const {
+		
+		// Buscamos un nodo que contenga esa clave.
+		Nodo *nodo = buscaNodo(clave);
+		if (nodo == NULL)
+			throw EClaveErronea();
+		
+		return nodo->_valor;
+	}
+
+	/**
+	 * Implementacin de busca para claves de tipo C o compatibles.
+	 */
+	template <class K>
+	V *buscaAux(const K &clave) const {
+		Nodo *nodo = buscaNodo(clave);
+		return (nodo == NULL) ? NULL : &nodo->_valor;
+	}
+
+	/**
+	 * Indica si la ocupacin ha superado el mximo y hay que ampliar.
+	 * Se calcula en 64 bits para que el producto no desborde en tablas
+	 * grandes.
+	 */
+	bool llena() const {
+		return _tam < TAM_MAXIMO &&
+				100ULL * _numElems > (unsigned long long) _maxOcupacion * _tam;
+	}
+
+	/**
+	 * Calcula el menor tamao (potencia de dos, al menos TAM_INICIAL) con
+	 * el que numElems elementos no superan la ocupacin mxima, o
+	 * TAM_MAXIMO si hiciera falta ms.
+	 */
+	unsigned int tamPara(unsigned int numElems) const {
+		unsigned long long tam = TAM_INICIAL;
+		while (tam < TAM_MAXIMO &&
+				100ULL * numElems > (unsigned long long) _maxOcupacion * tam)
+			tam *= 2;
+		return (unsigned int) tam;
+	}
+
 	/**
 	 * Este mtodo duplica la capacidad del array de punteros actual.
 	 */
 	void amplia() {
+		redimensiona(_tam * 2, _incremental);
+	}
+
+	/**
+	 * Cambia el array de punteros por otro de tamao nuevoTam (potencia
+	 * de dos mayor que el actual) y reparte en l los nodos.
+	 *
+	 * @param nuevoTam tamao del nuevo array.
+	 * @param incremental si los nodos se trasladan poco a poco desde las
+	 *        operaciones modificadoras en lugar de ahora.
+	 */
+	void redimensiona(unsigned int nuevoTam, bool incremental) {
+		// Si quedaba una ampliacin incremental a medias, la terminamos.
+		trasladaCubos(_tamAnt);
+
 		// Creamos un puntero al array actual y anotamos su tamao.
 		Nodo **vAnt = _v;
 		unsigned int tamAnt = _tam;
 
-		// Duplicamos el array en otra posicin de memoria.
-		_tam *= 2; 
-		_v = new Nodo*[_tam];
-		for (unsigned int i=0; i<_tam; ++i)
-			_v[i] = NULL;
+		// Creamos el nuevo array en otra posicin de memoria.
+		_tam = nuevoTam; 
+		_v = nuevoArray(_tam);
+		_numAmpliaciones++;
+
+		// En modo incremental los nodos se irn trasladando poco a poco
+		// desde las operaciones modificadoras (ver trasladaCubos).
+		if (incremental) {
+			_vAnt = vAnt;
+			_tamAnt = tamAnt;
+			_migrados = 0;
+			return;
+		}
 		
 		// Recorremos el array original moviendo cada nodo a la nueva 
 		// posicin que le corresponde en el nuevo array.
@@ -400,14 +871,68 @@ private:
 				
 				// Calculamos el nuevo ndice del nodo, lo desenganchamos del 
 				// array antiguo y lo enganchamos al nuevo.
-				unsigned int ind = ::hash(aux->_clave) % _tam;
+				unsigned int ind = indice(aux->_clave);
 				aux->_sig = _v[ind];
 				_v[ind] = aux;
 			}
 		}
 		
 		// Borramos el array antiguo (ya no contiene ningn nodo).
-		delete[] vAnt;
+		liberaArray(vAnt);
+	}
+
+	/**
+	 * Reserva un array de n punteros a nodo inicializados a NULL. Se usa
+	 * calloc porque en arrays grandes el sistema entrega pginas ya
+	 * puestas a cero, as que ampliar la tabla no obliga a recorrer el
+	 * array nuevo para inicializarlo.
+	 *
+	 * @param n nmero de posiciones del array.
+	 * @return array reservado (se libera con liberaArray).
+	 */
+	static Nodo** nuevoArray(unsigned int n) {
+		Nodo **v = (Nodo**) calloc(n, sizeof(Nodo*));
+		if (v == NULL)
+			throw std::bad_alloc();
+		return v;
+	}
+
+	/**
+	 * Libera un array reservado con nuevoArray (se admite NULL).
+	 */
+	static void liberaArray(Nodo **v) {
+		free(v);
+	}
+
+	/**
+	 * Traslada al array nuevo los nodos de las n siguientes posiciones del
+	 * array antiguo que queda de una ampliacin incremental. Cuando se han
+	 * trasladado todas, se libera el array antiguo. Si no hay ninguna
+	 * ampliacin en curso no hace nada.
+	 *
+	 * @param n nmero mximo de posiciones a trasladar.
+	 */
+	void trasladaCubos(unsigned int n) {
+		while ((_vAnt != NULL) && (n > 0)) {
+			Nodo *nodo = _vAnt[_migrados];
+			_vAnt[_migrados] = NULL;
+			while (nodo != NULL) {
+				Nodo *aux = nodo;
+				nodo = nodo->_sig;
+				unsigned int ind = indice(aux->_clave);
+				aux->_sig = _v[ind];
+				_v[ind] = aux;
+			}
+			_migrados++;
+			n--;
+
+			if (_migrados == _tamAnt) {
+				liberaArray(_vAnt);
+				_vAnt = NULL;
+				_tamAnt = 0;
+				_migrados = 0;
+			}
+		}
 	}
 	
 	/**
@@ -420,7 +945,8 @@ private:
 	 *            al finalizar indica el nodo encontrado o NULL.
 	 * @param ant [out] puntero al nodo anterior a "act" o NULL.
 	 */
-	static void buscaNodo(const C &clave, Nodo* &act, Nodo* &ant) {
+	template <class K>
+	static void buscaNodo(const K &clave, Nodo* &act, Nodo* &ant) {
 		ant = NULL;
 		bool encontrado = false;
 		while ((act != NULL) && !encontrado) {
@@ -444,22 +970,96 @@ private:
 	 * @param prim nodo a partir del cual realizar la bsqueda. 
 	 * @return nodo encontrado o NULL.
 	 */
-	static Nodo* buscaNodo(const C &clave, Nodo* prim) {
+	template <class K>
+	static Nodo* buscaNodo(const K &clave, Nodo* prim) {
 		Nodo *act = prim;
 		Nodo *ant = NULL;
 		buscaNodo(clave, act, ant);
 		return act;
 	}
-		
+
 	/**
-	 * Ocupacin mxima permitida antes de ampliar la tabla en tanto por cientos.
+	 * Busca en la tabla el nodo que contiene la clave dada.
+	 *
+	 * @param clave clave del nodo que se busca (de tipo C o compatible).
+	 * @return nodo encontrado o NULL.
 	 */
-	static const unsigned int MAX_OCUPACION = 80;
+	template <class K>
+	Nodo* buscaNodo(const K &clave) const {
+		return buscaNodo(clave, *cuboDe(clave));
+	}
+
+	/**
+	 * Devuelve un puntero a la posicin (del array _v, o de _vAnt si hay
+	 * una ampliacin incremental en curso y esa posicin an no se ha
+	 * trasladado) en la que est o debe ir la clave dada. Como los
+	 * tamaos son potencias de dos, la posicin en _vAnt de una clave es
+	 * la de _v quitndole el bit ms alto.
+	 *
+	 * @param clave clave cuya posicin se quiere calcular.
+	 * @return puntero al primer nodo de la lista de esa posicin.
+	 */
+	template <class K>
+	Nodo** cuboDe(const K &clave) const {
+		unsigned int h = ::mezcla(::hash(clave));
+		if (_vAnt != NULL) {
+			unsigned int indAnt = h & (_tamAnt - 1);
+			if (indAnt >= _migrados)
+				return &_vAnt[indAnt];
+		}
+		return &_v[h & (_tam - 1)];
+	}
+
+	/**
+	 * Nmero de posiciones que se recorren al iterar: las de _v seguidas
+	 * de las de _vAnt si hay una ampliacin incremental en curso.
+	 */
+	unsigned int numCubos() const {
+		return _tam + _tamAnt;
+	}
+
+	/**
+	 * Devuelve el primer nodo de la posicin i-sima del recorrido,
+	 * con i en [0..numCubos()-1].
+	 */
+	Nodo* cubo(unsigned int i) const {
+		return (i < _tam) ? _v[i] : _vAnt[i - _tam];
+	}
+
+	/**
+	 * Devuelve la posicin del array _v (el nuevo, si hay una ampliacin
+	 * incremental en curso) que corresponde a la clave dada.
+	 * Como _tam es potencia de dos, el mdulo se reduce a quedarse con
+	 * los bits bajos del hash mezclado.
+	 *
+	 * @param clave clave cuya posicin se quiere calcular.
+	 * @return ndice en el array _v.
+	 */
+	template <class K>
+	unsigned int indice(const K &clave) const {
+		return ::mezcla(::hash(clave)) & (_tam - 1);
+	}
+
+	/**
+	 * Posiciones del array antiguo que traslada cada operacin
+	 * modificadora durante una ampliacin incremental. Una ampliacin
+	 * termina mucho antes de que la ocupacin obligue a empezar otra.
+	 */
+	static const unsigned int CUBOS_POR_PASO = 8;
 	
 	
 	Nodo **_v;               ///< Array de punteros a Nodo.
 	unsigned int _tam;       ///< Tamao del array _v.
 	unsigned int _numElems;  ///< Nmero de elementos en la tabla.
+	unsigned int _maxOcupacion; ///< Ocupacin mxima en tanto por ciento.
+	PoolNodos<Nodo> _pool;   ///< Almacn del que salen los nodos.
+
+	Nodo **_vAnt;            ///< Array antiguo (ampliacin incremental) o NULL.
+	unsigned int _tamAnt;    ///< Tamao de _vAnt (0 si es NULL).
+	unsigned int _migrados;  ///< Posiciones de _vAnt ya trasladadas.
+	bool _incremental;       ///< Si se usa la ampliacin incremental.
+
+	unsigned int _numAmpliaciones; ///< Veces que se ha ampliado el array.
 	
 
 };
@@ -0,0 +1,655 @@
+/**
+ @file TablaCerrada.h
+
+ Implementacin del TAD Tabla usando una tabla hash cerrada
+ (direccionamiento abierto) con la poltica Robin Hood.
+
+ Estructura de Datos y Algoritmos
+ Facultad de Informtica
+ Universidad Complutense de Madrid
+ */
+#ifndef __TABLA_CERRADA_H
+#define __TABLA_CERRADA_H
+
+#include "Excepciones.h"
+#include "Hash.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+
+
+
+
+// ---------------------------------------------
+//
+// TAD Tabla (hash cerrada)
+//
+// ---------------------------------------------
+
+
+
+
+/**
+ Implementacin del TAD Tabla usando una tabla hash cerrada. Todos los
+ pares (clave, valor) se guardan en un nico array de celdas contiguas,
+ por lo que las bsquedas no tienen que seguir punteros. Las colisiones
+ se resuelven con exploracin lineal y la poltica Robin Hood: al
+ insertar, un elemento que est ms lejos de su posicin ideal le quita
+ la celda a otro que est ms cerca de la suya. As las distancias se
+ mantienen cortas y parecidas, y una bsqueda fallida puede terminar en
+ cuanto encuentra un elemento ms cercano a su posicin que la clave
+ buscada.
+
+ Ofrece las mismas operaciones pblicas que Tabla, por lo que se puede
+ usar en su lugar cambiando nicamente el tipo:
+
+ - TablaVacia: -> Tabla. Generadora (constructor).
+ - inserta: Tabla, Clave, Valor -> Tabla. Generadora.
+ - borra: Tabla, Clave -> Tabla. Modificadora.
+ - esta: Tabla, Clave -> Bool. Observadora.
+ - consulta: Tabla, Clave - -> Valor. Observadora parcial.
+ - esVacia: Tabla -> Bool. Observadora.
+
+ Las claves y los valores deben tener constructor sin parmetros, ya que
+ las celdas libres del array los contienen igualmente.
+ */
+template <class C, class V>
+class TablaCerrada {
+public:
+
+	/**
+	 * Par (clave, valor) guardado en la tabla. Es lo que devuelve *it al
+	 * recorrerla con un Iterador: una referencia al par dentro de su
+	 * celda, vlida aunque el iterador avance (mientras no se modifique
+	 * la tabla).
+	 */
+	class Par {
+	public:
+		const C& clave() const { return _clave; }
+		const V& valor() const { return _valor; }
+
+		/* Atributos pblicos. */
+		C _clave;
+		V _valor;
+	};
+
+private:
+
+	/**
+	 * Cada celda del array contiene un par (clave, valor) y la distancia
+	 * (ms uno) entre la celda y la posicin ideal de la clave. Una
+	 * distancia 0 indica que la celda est libre.
+	 */
+	class Celda : public Par {
+	public:
+		/* Constructor. */
+		Celda() : _dist(0) {};
+
+		/* Atributos pblicos. */
+		unsigned int _dist;  // 0 si est libre, distancia + 1 si no.
+	};
+
+	/**
+	 * Tipo R, pero slo si K es un tipo de clave compatible con C (ver
+	 * ClaveCompatible en Hash.h).
+	 */
+	template <class K, class R>
+	using SiCompatible = typename std::enable_if<
+		ClaveCompatible<C, typename std::decay<K>::type>::valor, R>::type;
+
+public:
+
+	/**
+	 * Tamao inicial de la tabla. El tamao es siempre una potencia de
+	 * dos para poder calcular las posiciones con una mscara.
+	 */
+	static const int TAM_INICIAL = 16;
+
+	/**
+	 * Constructor por defecto. Crea una tabla con TAM_INICIAL
+	 * posiciones.
+	 */
+	TablaCerrada() : _v(new Celda[TAM_INICIAL]), _tam(TAM_INICIAL),
+			_numElems(0) {
+	}
+
+	/**
+	 * Destructor.
+	 */
+	~TablaCerrada() {
+		libera();
+	}
+
+	/**
+	 * Inserta un nuevo par (clave, valor) en la tabla. Si ya exista un
+	 * elemento con esa clave, se actualiza su valor.
+	 *
+	 * @param clave clave del nuevo elemento.
+	 * @param valor valor del nuevo elemento.
+	 */
+	void inserta(const C &clave, const V &valor) {
+
+		// Si la clave ya exista, actualizamos su valor
+		unsigned int ind = buscaCelda(clave);
+		if (ind != _tam) {
+			_v[ind]._valor = valor;
+			return;
+		}
+
+		// Trabajamos sobre copias porque la insercin Robin Hood va
+		// intercambiando el par a colocar con los que desplaza. Se hacen
+		// antes de ampliar, porque clave o valor pueden ser elementos de
+		// la propia tabla y amplia los saca del vector antiguo.
+		C c = clave;
+		V v = valor;
+
+		// Si la ocupacin es muy alta ampliamos la tabla
+		// (en 64 bits para que el producto no desborde en tablas grandes)
+		if (100ULL * (_numElems + 1) > (unsigned long long) MAX_OCUPACION * _tam)
+			amplia();
+
+		coloca(c, v);
+		_numElems++;
+	}
+
+	/**
+	 * Igual que la anterior, pero mueve la clave y el valor a la tabla en
+	 * lugar de copiarlos.
+	 *
+	 * @param clave clave del nuevo elemento.
+	 * @param valor valor del nuevo elemento.
+	 */
+	void inserta(C &&clave, V &&valor) {
+
+		unsigned int ind = buscaCelda(clave);
+		if (ind != _tam) {
+			_v[ind]._valor = std::move(valor);
+			return;
+		}
+
+		if (100ULL * (_numElems + 1) > (unsigned long long) MAX_OCUPACION * _tam)
+			amplia();
+
+		// Podemos intercambiar directamente los parmetros, que no se
+		// volvern a usar.
+		coloca(clave, valor);
+		_numElems++;
+	}
+
+	/**
+	 * Inserta la clave dada construyendo su valor a partir de los
+	 * argumentos "args" (equivalente a try_emplace de la STL). Si la clave
+	 * ya exista la tabla no se modifica y el valor no llega a construirse.
+	 * La clave puede ser tambin de un tipo compatible con C.
+	 *
+	 * @param clave clave del nuevo elemento.
+	 * @param args argumentos para el constructor del valor.
+	 * @return true si se ha insertado el elemento; false si la clave ya
+	 *         estaba en la tabla.
+	 */
+	template <class... Args>
+	bool emplaza(const C &clave, Args&&... args) {
+		return emplazaAux(clave, std::forward<Args>(args)...);
+	}
+
+	template <class... Args>
+	bool emplaza(C &&clave, Args&&... args) {
+		return emplazaAux(std::move(clave), std::forward<Args>(args)...);
+	}
+
+	template <class K, class... Args>
+	SiCompatible<K, bool> emplaza(const K &clave, Args&&... args) {
+		return emplazaAux(clave, std::forward<Args>(args)...);
+	}
+
+	/**
+	 * Elimina el elemento de la tabla con la clave dada. Si no exista ningn
+	 * elemento con dicha clave, la tabla no se modifica.
+	 *
+	 * @param clave clave del elemento a eliminar.
+	 */
+	void borra(const C &clave) {
+		borraAux(clave);
+	}
+
+	template <class K>
+	SiCompatible<K, void> borra(const K &clave) {
+		borraAux(clave);
+	}
+
+	/**
+	 * Comprueba si la tabla contiene algn elemento con la clave dada.
+	 *
+	 * @param clave clave a buscar.
+	 * @return si existe algn elemento con esa clave.
+	 */
+	bool esta(const C &clave) const {
+		return buscaCelda(clave) != _tam;
+	}
+
+	template <class K>
+	SiCompatible<K, bool> esta(const K &clave) const {
+		return buscaCelda(clave) != _tam;
+	}
+
+	/**
+	 * Devuelve el valor asociado a la clave dada. Si la tabla no contiene
+	 * esa clave lanza una excepcin.
+	 *
+	 * @param clave clave del elemento a buscar.
+	 * @return valor asociado a dicha clave.
+	 * @throw EClaveErronea si la clave no existe en la tabla.
+	 */
+	const V &consulta(const C &clave) const {
+		return consultaAux(clave);
+	}
+
+	template <class K>
+	SiCompatible<K, const V &> consulta(const K &clave) const {
+		return consultaAux(clave);
+	}
+
+	/**
+	 * Devuelve un puntero al valor asociado a la clave dada, o NULL si la
+	 * tabla no contiene esa clave. A diferencia de consulta no lanza
+	 * ninguna excepcin, por lo que es preferible cuando se espera que
+	 * muchas bsquedas fallen. El puntero deja de ser vlido al modificar
+	 * la tabla.
+	 *
+	 * @param clave clave del elemento a buscar.
+	 * @return puntero al valor asociado a la clave o NULL.
+	 */
+	const V *busca(const C &clave) const {
+		return buscaAux(clave);
+	}
+
+	V *busca(const C &clave) {
+		return buscaAux(clave);
+	}
+
+	template <class K>
+	SiCompatible<K, const V *> busca(const K &clave) const {
+		return buscaAux(clave);
+	}
+
+	template <class K>
+	SiCompatible<K, V *> busca(const K &clave) {
+		return buscaAux(clave);
+	}
+
+	/**
+	 * Indica si la tabla est vaca, es decir, si no contiene ningn elemento.
+	 *
+	 * @return si la tabla est vaca.
+	 */
+	bool esVacia() const {
+		return _numElems == 0;
+	}
+
+	/**
+	 * Clase interna que implementa un iterador sobre el conjunto de pares
+	 * (clave, valor). Los pares se recorren en el orden en que aparecen en
+	 * el array de celdas, que no guarda relacin con el de insercin. Igual
+	 * que el de Tabla, tambin es un iterador de la STL cuyo *it es el
+	 * Par de la celda actual.
+	 */
+	class Iterador {
+	public:
+		/** Iterador que no recorre ninguna tabla. */
+		Iterador() : _tabla(NULL), _ind(0) { }
+
+		void avanza() {
+			if (_ind >= _tabla->_tam) throw EAccesoInvalido();
+			operator++();
+		}
+
+		const C& clave() const {
+			if (_ind >= _tabla->_tam) throw EAccesoInvalido();
+			return _tabla->_v[_ind]._clave;
+		}
+
+		const V& valor() const {
+			if (_ind >= _tabla->_tam) throw EAccesoInvalido();
+			return _tabla->_v[_ind]._valor;
+		}
+
+		bool operator==(const Iterador &other) const {
+			return _ind == other._ind;
+		}
+
+		bool operator!=(const Iterador &other) const {
+			return !(this->operator==(other));
+		}
+
+		// Operadores de iterador de avance de la STL. *it devuelve una
+		// referencia al Par de la celda, as que no se copia y sigue
+		// siendo vlida al avanzar. operator++ slo comprueba con assert
+		// que no estemos en el final.
+		typedef std::forward_iterator_tag iterator_category;
+		typedef Par value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const Par *pointer;
+		typedef const Par &reference;
+
+		const Par &operator*() const {
+			assert(_ind < _tabla->_tam);
+			return _tabla->_v[_ind];
+		}
+
+		const Par *operator->() const {
+			assert(_ind < _tabla->_tam);
+			return &_tabla->_v[_ind];
+		}
+
+		Iterador &operator++() {
+			assert(_ind < _tabla->_tam);
+
+			// Saltamos a la siguiente celda ocupada (o al final).
+			_ind = _tabla->siguienteOcupada(_ind + 1);
+			return *this;
+		}
+
+		Iterador operator++(int) {
+			Iterador ret(*this);
+			operator++();
+			return ret;
+		}
+
+	private:
+		// Para que pueda construir objetos del tipo iterador
+		friend class TablaCerrada;
+
+		Iterador(const TablaCerrada* tabla, unsigned int ind)
+			: _tabla(tabla), _ind(ind) { }
+
+
+		const TablaCerrada *_tabla;	///< Tabla que se est recorriendo
+		unsigned int _ind;			///< Celda actual (_tam si es el final)
+
+	};
+
+	/**
+	 * Devuelve un iterador al primer par (clave, valor) de la tabla.
+	 * El iterador devuelto coincidir con final() si la tabla est vaca.
+	 * @return iterador al primer par (clave, valor) de la tabla.
+	 */
+	Iterador principio() const {
+		return Iterador(this, siguienteOcupada(0));
+	}
+
+	/**
+	 * Devuelve un iterador al final del recorrido (apunta ms all del ltimo
+	 * elemento de la tabla).
+	 * @return iterador al final del recorrido.
+	 */
+	Iterador final() const {
+		return Iterador(this, _tam);
+	}
+
+	/** Equivalentes a principio() y final() con los nombres de la STL. */
+	Iterador begin() const {
+		return principio();
+	}
+
+	Iterador end() const {
+		return final();
+	}
+
+
+	//
+	// MTODOS DE "FONTANERA" DE C++ QUE HACEN VERSTIL A LA CLASE
+	//
+
+	/**
+	 * Constructor por copia.
+	 *
+	 * @param other tabla que se quiere copiar.
+	 */
+	TablaCerrada(const TablaCerrada<C,V> &other) {
+		copia(other);
+	}
+
+	/**
+	 * Operador de asignacin.
+	 *
+	 * @param other tabla que se quiere copiar.
+	 * @return referencia a este mismo objeto (*this).
+	 */
+	TablaCerrada<C,V> &operator=(const TablaCerrada<C,V> &other) {
+		if (this != &other) {
+			libera();
+			copia(other);
+		}
+		return *this;
+	}
+
+
+private:
+
+	// Para que el iterador pueda acceder a la parte privada
+	friend class Iterador;
+
+	/**
+	 * Libera toda la memoria dinmica reservada para la tabla.
+	 */
+	void libera() {
+		delete[] _v;
+		_v = NULL;
+	}
+
+	/**
+	 * Hace una copia de la tabla que recibe como parmetro. Antes de llamar
+	 * a este mtodo se debe invocar al mtodo "libera". Las celdas se
+	 * copian tal cual, por lo que no hay que volver a calcular posiciones.
+	 *
+	 * @param other tabla que se quiere copiar.
+	 */
+	void copia(const TablaCerrada<C,V> &other) {
+		_tam = other._tam;
+		_numElems = other._numElems;
+		_v = new Celda[_tam];
+		for (unsigned int i=0; i<_tam; ++i)
+			_v[i] = other._v[i];
+	}
+
+	/**
+	 * Implementacin de emplaza. La clave puede ser de tipo C o de un
+	 * tipo compatible; en ambos casos la clave y el valor se construyen
+	 * slo si la clave no estaba.
+	 */
+	template <class K, class... Args>
+	bool emplazaAux(K &&clave, Args&&... args) {
+
+		if (buscaCelda(clave) != _tam)
+			return false;
+
+		// Como en inserta, antes de que amplia cambie de vector.
+		C c(std::forward<K>(clave));
+		V v(std::forward<Args>(args)...);
+
+		if (100ULL * (_numElems + 1) > (unsigned long long) MAX_OCUPACION * _tam)
+			amplia();
+
+		coloca(c, v);
+		_numElems++;
+		return true;
+	}
+
+	/**
+	 * Implementacin de borra para claves de tipo C o compatibles.
+	 */
+	template <class K>
+	void borraAux(const K &clave) {
+
+		unsigned int ind = buscaCelda(clave);
+		if (ind == _tam)
+			return;
+
+		// Desplazamos hacia atrs los elementos siguientes hasta encontrar
+		// una celda libre o un elemento que ya est en su posicin ideal.
+		// As no hace falta marcar celdas como borradas.
+		unsigned int sig = siguiente(ind);
+		while (_v[sig]._dist > 1) {
+			std::swap(_v[ind]._clave, _v[sig]._clave);
+			std::swap(_v[ind]._valor, _v[sig]._valor);
+			_v[ind]._dist = _v[sig]._dist - 1;
+			ind = sig;
+			sig = siguiente(sig);
+		}
+
+		// Liberamos la celda; reasignamos clave y valor para que no
+		// conserven recursos del elemento borrado.
+		_v[ind]._clave = C();
+		_v[ind]._valor = V();
+		_v[ind]._dist = 0;
+		_numElems--;
+	}
+
+	/**
+	 * Implementacin de consulta para claves de tipo C o compatibles.
+	 */
+	template <class K>
+	const V &consultaAux(const K &clave) const {
+
+		unsigned int ind = buscaCelda(clave);
+		if (ind == _tam)
+			throw EClaveErronea();
+
+		return _v[ind]._valor;
+	}
+
+	/**
+	 * Implementacin de busca para claves de tipo C o compatibles.
+	 */
+	template <class K>
+	V *buscaAux(const K &clave) const {
+		unsigned int ind = buscaCelda(clave);
+		return (ind == _tam) ? NULL : &_v[ind]._valor;
+	}
+
+	/**
+	 * Este mtodo duplica la capacidad del array de celdas y recoloca
+	 * todos los elementos.
+	 */
+	void amplia() {
+		Celda *vAnt = _v;
+		unsigned int tamAnt = _tam;
+
+		_tam *= 2;
+		_v = new Celda[_tam];
+
+		// Las claves y valores del array antiguo se pueden destruir, as
+		// que "coloca" los intercambia en lugar de copiarlos.
+		for (unsigned int i=0; i<tamAnt; ++i) {
+			if (vAnt[i]._dist != 0)
+				coloca(vAnt[i]._clave, vAnt[i]._valor);
+		}
+
+		delete[] vAnt;
+	}
+
+	/**
+	 * Coloca un par (clave, valor) que no est en la tabla siguiendo la
+	 * poltica Robin Hood. Se supone que queda al menos una celda libre.
+	 * La clave y el valor recibidos se intercambian con los de los
+	 * elementos desplazados, por lo que a la salida su contenido no est
+	 * definido.
+	 *
+	 * @param clave clave a colocar.
+	 * @param valor valor a colocar.
+	 */
+	void coloca(C &clave, V &valor) {
+		unsigned int ind = indice(clave);
+		unsigned int dist = 1;
+
+		while (_v[ind]._dist != 0) {
+			// Si el elemento que ocupa la celda est ms cerca de su
+			// posicin ideal que nosotros, le quitamos la celda y seguimos
+			// buscando sitio para l.
+			if (_v[ind]._dist < dist) {
+				std::swap(_v[ind]._clave, clave);
+				std::swap(_v[ind]._valor, valor);
+				std::swap(_v[ind]._dist, dist);
+			}
+			ind = siguiente(ind);
+			dist++;
+		}
+
+		std::swap(_v[ind]._clave, clave);
+		std::swap(_v[ind]._valor, valor);
+		_v[ind]._dist = dist;
+	}
+
+	/**
+	 * Busca la celda que contiene la clave dada.
+	 *
+	 * @param clave clave que se busca.
+	 * @return ndice de la celda o _tam si la clave no est en la tabla.
+	 */
+	template <class K>
+	unsigned int buscaCelda(const K &clave) const {
+		unsigned int ind = indice(clave);
+		unsigned int dist = 1;
+
+		// Si llegamos a una celda libre o a un elemento ms cercano a su
+		// posicin ideal que la clave buscada, la clave no est. Slo los
+		// elementos a la misma distancia comparten posicin ideal con la
+		// clave, as que son los nicos que hay que comparar.
+		while (_v[ind]._dist >= dist) {
+			if ((_v[ind]._dist == dist) && (_v[ind]._clave == clave))
+				return ind;
+			ind = siguiente(ind);
+			dist++;
+		}
+		return _tam;
+	}
+
+	/**
+	 * Devuelve la posicin ideal de la clave dada en el array de celdas.
+	 * Como _tam es potencia de dos, el mdulo se reduce a quedarse con
+	 * los bits bajos del hash mezclado.
+	 */
+	template <class K>
+	unsigned int indice(const K &clave) const {
+		return ::mezcla(::hash(clave)) & (_tam - 1);
+	}
+
+	/**
+	 * Devuelve el ndice de la celda siguiente a la dada, volviendo al
+	 * principio del array al llegar al final.
+	 */
+	unsigned int siguiente(unsigned int ind) const {
+		return (ind + 1) & (_tam - 1);
+	}
+
+	/**
+	 * Devuelve el ndice de la primera celda ocupada a partir de la dada
+	 * (incluida), o _tam si no hay ninguna.
+	 */
+	unsigned int siguienteOcupada(unsigned int ind) const {
+		while ((ind < _tam) && (_v[ind]._dist == 0))
+			++ind;
+		return ind;
+	}
+
+	/**
+	 * Ocupacin mxima permitida antes de ampliar la tabla en tanto por
+	 * cientos. Robin Hood mantiene las distancias cortas incluso con una
+	 * ocupacin alta.
+	 */
+	static const unsigned int MAX_OCUPACION = 90;
+
+
+	Celda *_v;               ///< Array de celdas.
+	unsigned int _tam;       ///< Tamao del array _v.
+	unsigned int _numElems;  ///< Nmero de elementos en la tabla.
+
+
+};
+
+#endif // __TABLA_CERRADA_H
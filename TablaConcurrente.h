@@ -0,0 +1,256 @@
+/**
+ @file TablaConcurrente.h
+
+ Implementacin del TAD Tabla para usar desde varios hilos a la vez,
+ dividida en fragmentos protegidos cada uno por su propio cerrojo.
+
+ Estructura de Datos y Algoritmos
+ Facultad de Informtica
+ Universidad Complutense de Madrid
+ */
+#ifndef __TABLA_CONCURRENTE_H
+#define __TABLA_CONCURRENTE_H
+
+#include "Excepciones.h"
+#include "Hash.h"
+#include "Tabla.h"
+
+#include <mutex>
+#include <utility>
+
+#if __cplusplus >= 201703L
+#include <shared_mutex>
+#endif
+
+
+
+
+
+// ---------------------------------------------
+//
+// TAD Tabla (concurrente)
+//
+// ---------------------------------------------
+
+
+
+
+/**
+ Implementacin del TAD Tabla que se puede usar desde varios hilos a la
+ vez sin ningn cerrojo externo. Los elementos se reparten entre varios
+ fragmentos segn los bits altos de su hash (mezclado), y cada fragmento
+ es una Tabla normal con su propio cerrojo. Dos operaciones slo se
+ esperan entre s si sus claves caen en el mismo fragmento, y como Tabla
+ usa los bits bajos del hash para elegir la posicin, el reparto en
+ fragmentos no empeora el reparto dentro de cada uno.
+
+ Con C++17 cada cerrojo es de lectura/escritura: las consultas de un
+ mismo fragmento se hacen a la vez y slo las modificaciones son
+ exclusivas. Con versiones anteriores el cerrojo es un mutex normal.
+ Los fragmentos estn separados entre s al menos una lnea de cach,
+ para que los cerrojos de fragmentos distintos no se estorben.
+
+ Las operaciones son:
+
+ - TablaVacia: -> Tabla. Generadora (constructor).
+ - inserta: Tabla, Clave, Valor -> Tabla. Generadora.
+ - modifica: Tabla, Clave, Valor, Funcin -> Tabla. Generadora.
+ - borra: Tabla, Clave -> Tabla. Modificadora.
+ - esta: Tabla, Clave -> Bool. Observadora.
+ - consulta: Tabla, Clave - -> Valor. Observadora parcial.
+ - busca: Tabla, Clave -> Bool, Valor. Observadora.
+ - esVacia: Tabla -> Bool. Observadora.
+
+ Como otro hilo puede borrar o cambiar un elemento en cualquier momento,
+ consulta devuelve una copia del valor y no hay iteradores.
+ */
+template <class C, class V>
+class TablaConcurrente {
+public:
+
+	/** Nmero de fragmentos por defecto. */
+	static const unsigned int NUM_FRAGMENTOS = 64;
+
+	/**
+	 * Constructor.
+	 *
+	 * @param numFragmentos nmero de fragmentos (potencia de dos). Conviene
+	 *        que sea bastante mayor que el nmero de hilos que usan la
+	 *        tabla a la vez.
+	 * @throws IllegalArgumentException si numFragmentos no es una
+	 *         potencia de dos.
+	 */
+	explicit TablaConcurrente(unsigned int numFragmentos = NUM_FRAGMENTOS) :
+			_fragmentos(NULL), _numFragmentos(numFragmentos), _bits(0) {
+		if (numFragmentos == 0 || (numFragmentos & (numFragmentos - 1)) != 0)
+			throw IllegalArgumentException("Numero de fragmentos no es potencia de dos");
+		_fragmentos = new Fragmento[numFragmentos];
+		while ((1U << _bits) < numFragmentos)
+			_bits++;
+	}
+
+	/**
+	 * Destructor. Ningn otro hilo puede estar usando la tabla.
+	 */
+	~TablaConcurrente() {
+		delete[] _fragmentos;
+	}
+
+	/**
+	 * Inserta un nuevo par (clave, valor) en la tabla. Si ya exista un
+	 * elemento con esa clave, se actualiza su valor.
+	 *
+	 * @param clave clave del nuevo elemento.
+	 * @param valor valor del nuevo elemento.
+	 */
+	void inserta(const C &clave, const V &valor) {
+		Fragmento &f = fragmento(clave);
+		Exclusivo cerrojo(f._cerrojo);
+		f._tabla.inserta(clave, valor);
+	}
+
+	void inserta(C &&clave, V &&valor) {
+		Fragmento &f = fragmento(clave);
+		Exclusivo cerrojo(f._cerrojo);
+		f._tabla.inserta(std::move(clave), std::move(valor));
+	}
+
+	/**
+	 * Modifica de forma atmica el valor asociado a la clave: si la clave
+	 * no estaba, se inserta primero con el valor "inicial", y despus se
+	 * llama a op(valor). Ningn otro hilo ve la tabla entre los dos pasos,
+	 * as que sirve, por ejemplo, para contar apariciones desde varios
+	 * hilos. op no debe usar esta misma tabla.
+	 *
+	 * @param clave clave del elemento a modificar.
+	 * @param inicial valor de la clave si no estaba en la tabla.
+	 * @param op funcin u objeto que recibe el valor (V&) y lo modifica.
+	 */
+	template <class F>
+	void modifica(const C &clave, const V &inicial, F op) {
+		Fragmento &f = fragmento(clave);
+		Exclusivo cerrojo(f._cerrojo);
+		V *valor = f._tabla.busca(clave);
+		if (valor == NULL) {
+			f._tabla.emplaza(clave, inicial);
+			valor = f._tabla.busca(clave);
+		}
+		op(*valor);
+	}
+
+	/**
+	 * Elimina el elemento de la tabla con la clave dada. Si no exista ningn
+	 * elemento con dicha clave, la tabla no se modifica.
+	 *
+	 * @param clave clave del elemento a eliminar.
+	 */
+	void borra(const C &clave) {
+		Fragmento &f = fragmento(clave);
+		Exclusivo cerrojo(f._cerrojo);
+		f._tabla.borra(clave);
+	}
+
+	/**
+	 * Comprueba si la tabla contiene algn elemento con la clave dada.
+	 *
+	 * @param clave clave a buscar.
+	 * @return si existe algn elemento con esa clave.
+	 */
+	bool esta(const C &clave) const {
+		Fragmento &f = fragmento(clave);
+		Compartido cerrojo(f._cerrojo);
+		return f._tabla.esta(clave);
+	}
+
+	/**
+	 * Devuelve una copia del valor asociado a la clave dada. Si la tabla
+	 * no contiene esa clave lanza una excepcin.
+	 *
+	 * @param clave clave del elemento a buscar.
+	 * @return valor asociado a dicha clave.
+	 * @throw EClaveErronea si la clave no existe en la tabla.
+	 */
+	V consulta(const C &clave) const {
+		Fragmento &f = fragmento(clave);
+		Compartido cerrojo(f._cerrojo);
+		return f._tabla.consulta(clave);
+	}
+
+	/**
+	 * Copia en "valor" el valor asociado a la clave dada, si est. No
+	 * lanza ninguna excepcin cuando la clave no existe.
+	 *
+	 * @param clave clave del elemento a buscar.
+	 * @param valor [out] valor asociado a la clave, si est.
+	 * @return si existe algn elemento con esa clave.
+	 */
+	bool busca(const C &clave, V &valor) const {
+		Fragmento &f = fragmento(clave);
+		Compartido cerrojo(f._cerrojo);
+		const V *v = f._tabla.busca(clave);
+		if (v == NULL)
+			return false;
+		valor = *v;
+		return true;
+	}
+
+	/**
+	 * Indica si la tabla est vaca. Si otros hilos la estn modificando,
+	 * el resultado puede haber dejado de ser cierto al devolverlo.
+	 *
+	 * @return si la tabla est vaca.
+	 */
+	bool esVacia() const {
+		for (unsigned int i=0; i<_numFragmentos; ++i) {
+			Compartido cerrojo(_fragmentos[i]._cerrojo);
+			if (!_fragmentos[i]._tabla.esVacia())
+				return false;
+		}
+		return true;
+	}
+
+	// Los cerrojos no se pueden copiar, as que la tabla tampoco.
+	TablaConcurrente(const TablaConcurrente &) = delete;
+	TablaConcurrente &operator=(const TablaConcurrente &) = delete;
+
+private:
+
+#if __cplusplus >= 201703L
+	typedef std::shared_mutex Cerrojo;
+	typedef std::shared_lock<Cerrojo> Compartido;
+#else
+	typedef std::mutex Cerrojo;
+	typedef std::lock_guard<Cerrojo> Compartido;
+#endif
+	typedef std::lock_guard<Cerrojo> Exclusivo;
+
+	/**
+	 * Un fragmento es una Tabla con su cerrojo. El relleno final (64 bytes,
+	 * el tamao habitual de una lnea de cach) evita que el cerrojo de un
+	 * fragmento comparta lnea con los datos del anterior.
+	 */
+	struct Fragmento {
+		Cerrojo _cerrojo;
+		Tabla<C,V> _tabla;
+		char _relleno[64];
+	};
+
+	/**
+	 * Devuelve el fragmento que corresponde a la clave dada, elegido con
+	 * los bits altos del hash mezclado.
+	 */
+	Fragmento &fragmento(const C &clave) const {
+		if (_bits == 0)
+			return _fragmentos[0];
+		unsigned int h = ::mezcla(::hash(clave));
+		return _fragmentos[h >> (32 - _bits)];
+	}
+
+
+	Fragmento *_fragmentos;        ///< Array de fragmentos.
+	unsigned int _numFragmentos;   ///< Tamao del array _fragmentos.
+	unsigned int _bits;            ///< log2(_numFragmentos).
+
+};
+
+#endif // __TABLA_CONCURRENTE_H
@@ -0,0 +1,51 @@
+/**
+  @file Traslado.h
+
+  Funcin auxiliar para los TADs que guardan sus elementos en
+  vectores sin construir (Pila, PilaPequena y ColaCircular):
+  traslada los elementos de un vector a otro cuando el TAD
+  cambia de vector.
+
+  Estructura de Datos y Algoritmos
+  Facultad de Informtica
+  Universidad Complutense de Madrid
+*/
+#ifndef __TRASLADO_H
+#define __TRASLADO_H
+
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/** Traslada n elementos que se pueden copiar byte a byte. */
+template <class T>
+inline void trasladaElems(T *destino, T *origen, unsigned int n,
+		std::true_type) {
+	if (n > 0)
+		memcpy(static_cast<void *>(destino), origen, n * sizeof(T));
+}
+
+/** Traslada n elementos movindolos y destruyendo los originales. */
+template <class T>
+inline void trasladaElems(T *destino, T *origen, unsigned int n,
+		std::false_type) {
+	for (unsigned int i = 0; i < n; ++i) {
+		new (&destino[i]) T(std::move(origen[i]));
+		origen[i].~T();
+	}
+}
+
+/**
+ Traslada los n elementos de "origen" a "destino", que no
+ debe contener objetos: despus los elementos slo estn
+ construidos en destino. Si T se puede copiar byte a byte
+ se hace con un nico memcpy.
+ */
+template <class T>
+inline void trasladaElems(T *destino, T *origen, unsigned int n) {
+	trasladaElems(destino, origen, n, std::integral_constant<bool,
+			std::is_trivially_copyable<T>::value>());
+}
+
+#endif // __TRASLADO_H
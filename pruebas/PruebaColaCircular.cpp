@@ -0,0 +1,46 @@
+/*
+ * PruebaColaCircular.cpp
+ *
+ * Pruebas de regresin de ColaCircular.h. Se compila y ejecuta desde la
+ * raz del repositorio con:
+ *
+ *   g++ -std=c++11 -I. pruebas/PruebaColaCircular.cpp && ./a.out
+ */
+
+#include "ColaCircular.h"
+
+#include <cassert>
+#include <iostream>
+#include <string>
+
+// Poner en la doble cola, cuando est llena, uno de sus propios
+// elementos: el vector se cambia al crecer, y el elemento tiene que
+// copiarse antes.
+static void ponElementoPropioConLaColaLlena() {
+	DColaCircular<std::string> d;
+	for (int i = 0; i < DColaCircular<std::string>::TAM_INICIAL; ++i)
+		d.ponDetras(std::string(20, (char) ('a' + i)));
+	d.ponDetras(d.primero());
+	assert(d.ultimo() == std::string(20, 'a'));
+
+	DColaCircular<std::string> e;
+	for (int i = 0; i < DColaCircular<std::string>::TAM_INICIAL; ++i)
+		e.ponDetras(std::string(20, (char) ('a' + i)));
+	e.ponDelante(e.ultimo());
+	assert(e.primero() == std::string(20, 'a' + DColaCircular<std::string>::TAM_INICIAL - 1));
+	assert(e.numElems() == DColaCircular<std::string>::TAM_INICIAL + 1);
+
+	ColaCircular<std::string> c;
+	for (int i = 0; i < DColaCircular<std::string>::TAM_INICIAL; ++i)
+		c.ponDetras(std::string(20, (char) ('a' + i)));
+	c.ponDetras(c.primero());
+	for (int i = 0; i < DColaCircular<std::string>::TAM_INICIAL; ++i)
+		c.quitaPrim();
+	assert(c.primero() == std::string(20, 'a'));
+}
+
+int main() {
+	ponElementoPropioConLaColaLlena();
+	std::cout << "OK" << std::endl;
+	return 0;
+}